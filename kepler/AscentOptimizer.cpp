@@ -0,0 +1,182 @@
+//
+//  AscentOptimizer.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "AscentOptimizer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "RK4.hpp"
+
+static const int parameterCount = 3;
+
+static double& component(AscentParameters& p, int i) {
+    return i == 0 ? p.kickSpeed : (i == 1 ? p.kickAngle : p.azimuth);
+}
+
+static double component(const AscentParameters& p, int i) {
+    return i == 0 ? p.kickSpeed : (i == 1 ? p.kickAngle : p.azimuth);
+}
+
+AscentOptimizer::AscentOptimizer(const MassiveBody& planet, const Vehicle& vehicle, const Orbit& target,
+                                 const Settings& settings) :
+lower{20, radians(0.5), 0},
+upper{150, radians(15), M_PI},
+_planet(planet),
+_vehicle(vehicle),
+_settings(settings),
+_targetPeriapsis(target.periapsis()),
+_targetApoapsis(target.apoapsis()),
+_targetSemiMajorAxis(target.semiMajorAxis()),
+_targetInclination(target.inclination()),
+_propellant(0)
+{
+    if(vehicle.activeStage() != 0 || !vehicle.burning()) {
+        throw std::runtime_error("Ascents must be optimised from the launch pad");
+    }
+    if(settings.population < 4) {
+        throw std::runtime_error("Differential evolution needs a population of at least 4");
+    }
+    for(int i = 0; i < vehicle.stageCount(); ++i) {
+        _propellant += vehicle.stage(i).propellantMass;
+    }
+}
+
+AscentEvaluation AscentOptimizer::evaluate(const AscentParameters& parameters, Integrator& integrator) const {
+    auto vehicle = _vehicle;
+    const int last = vehicle.stageCount() - 1;
+    GravityTurn turn(parameters.kickSpeed, parameters.kickAngle, parameters.azimuth);
+    for(int i = 0; i < last; ++i) {
+        vehicle.setGuidance(i, turn);
+    }
+    const auto& engine = vehicle.stage(last).engine;
+    vehicle.setGuidance(last, PEG(_targetPeriapsis, _targetSemiMajorAxis,
+                                  engine.thrust(0), engine.Isp(0) * 9.81, _settings.pegPeriod));
+    
+    Clock clock;
+    bool crashed = false;
+    do {
+        vehicle.step(integrator, _planet, clock.now().value(), _settings.dt);
+        clock.advance(_settings.dt);
+        crashed = _planet.altitude(vehicle.stateVectors().p) < -1;
+    } while(!crashed && vehicle.burning() && vehicle.throttle() > 0);
+    
+    AscentEvaluation result;
+    result.parameters = parameters;
+    result.state = vehicle.stateVectors();
+    result.cutoff = vehicle.burning() && !crashed;
+    // Stages only separate once empty, so whatever is left is in the ones still attached.
+    result.propellant = _propellant;
+    for(int i = vehicle.activeStage(); i <= last; ++i) {
+        result.propellant -= vehicle.stage(i).propellantMass;
+    }
+    
+    if(crashed) {
+        result.cost = 10 * _propellant;
+        return result;
+    }
+    
+    // Misses are charged 1t of propellant per km of periapsis/apoapsis error and
+    // 10t per degree of inclination, which dwarfs any real saving.
+    Orbit orbit(_planet, result.state.p, result.state.v);
+    double apoapsis = std::isfinite(orbit.apoapsis()) ? orbit.apoapsis() : 10 * _targetApoapsis;
+    result.cost = result.propellant
+                + std::abs(orbit.periapsis() - _targetPeriapsis)
+                + std::abs(apoapsis - _targetApoapsis)
+                + 1e4 * std::abs(orbit.inclination() - _targetInclination);
+    return result;
+}
+
+AscentOptimizer::Result AscentOptimizer::optimize() const {
+    const int size = _settings.population;
+    int threads = _settings.threads > 0 ? _settings.threads : int(std::thread::hardware_concurrency());
+    threads = clamp(threads, 1, size);
+    
+    // Integrators keep per-step state, so each worker gets its own for the whole run.
+    std::vector<std::unique_ptr<Integrator>> integrators;
+    for(int i = 0; i < threads; ++i) {
+        integrators.emplace_back(new RK4());
+    }
+    
+    std::vector<AscentParameters> candidates(size);
+    std::vector<AscentEvaluation> evaluations(size);
+    auto evaluateAll = [&]() {
+        std::atomic<int> next{0};
+        auto work = [&](int worker) {
+            for(int i = next++; i < size; i = next++) {
+                evaluations[i] = evaluate(candidates[i], *integrators[worker]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for(int t = 1; t < threads; ++t) {
+            pool.emplace_back(work, t);
+        }
+        work(0);
+        for(auto& thread : pool) {
+            thread.join();
+        }
+    };
+    
+    // Candidates are always drawn on the calling thread, so a given seed gives the
+    // same result however many threads are used.
+    std::mt19937 rng{_settings.seed};
+    std::uniform_real_distribution<double> unit{0, 1};
+    std::uniform_int_distribution<int> pick{0, size - 1};
+    std::uniform_int_distribution<int> pickComponent{0, parameterCount - 1};
+    
+    for(auto& candidate : candidates) {
+        for(int i = 0; i < parameterCount; ++i) {
+            component(candidate, i) = lerp(component(lower, i), component(upper, i), float(unit(rng)));
+        }
+    }
+    evaluateAll();
+    auto population = evaluations;
+    
+    Result result;
+    result.evaluations = size;
+    result.generations = 0;
+    
+    for(int generation = 0; generation < _settings.generations; ++generation) {
+        auto best = std::min_element(population.begin(), population.end(),
+            [](const AscentEvaluation& a, const AscentEvaluation& b) { return a.cost < b.cost; });
+        auto worst = std::max_element(population.begin(), population.end(),
+            [](const AscentEvaluation& a, const AscentEvaluation& b) { return a.cost < b.cost; });
+        if(worst->cost - best->cost < _settings.tolerance) { break; }
+        
+        for(int i = 0; i < size; ++i) {
+            int a, b, c;
+            do { a = pick(rng); } while(a == i);
+            do { b = pick(rng); } while(b == i || b == a);
+            do { c = pick(rng); } while(c == i || c == a || c == b);
+            
+            int forced = pickComponent(rng);
+            auto& trial = candidates[i];
+            trial = population[i].parameters;
+            for(int k = 0; k < parameterCount; ++k) {
+                if(k != forced && unit(rng) >= _settings.crossover) { continue; }
+                double value = component(population[a].parameters, k)
+                    + _settings.differentialWeight * (component(population[b].parameters, k)
+                                                      - component(population[c].parameters, k));
+                component(trial, k) = clamp(value, component(lower, k), component(upper, k));
+            }
+        }
+        evaluateAll();
+        
+        for(int i = 0; i < size; ++i) {
+            if(evaluations[i].cost <= population[i].cost) { population[i] = evaluations[i]; }
+        }
+        result.evaluations += size;
+        result.generations += 1;
+    }
+    
+    result.best = *std::min_element(population.begin(), population.end(),
+        [](const AscentEvaluation& a, const AscentEvaluation& b) { return a.cost < b.cost; });
+    return result;
+}
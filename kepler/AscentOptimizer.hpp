@@ -0,0 +1,92 @@
+//
+//  AscentOptimizer.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <vector>
+#include "LaunchVehicle.hpp"
+#include "MassiveBody.hpp"
+#include "Integrator.hpp"
+#include "Orbit.hpp"
+
+/// Guidance parameters searched by the optimiser: the gravity turn flown by every
+/// stage but the last (angles in radians, azimuth clockwise from north).
+struct AscentParameters {
+    double  kickSpeed;
+    double  kickAngle;
+    double  azimuth;
+};
+
+/// Outcome of flying one set of parameters.
+struct AscentEvaluation {
+    AscentParameters    parameters;
+    /// Propellant burned plus penalties for missing the target, in kg.
+    double              cost;
+    double              propellant;
+    /// Whether the upper stage's guidance cut off before running dry.
+    bool                cutoff;
+    State               state;
+};
+
+/// Searches launch guidance for the cheapest ascent to a target orbit. Every stage
+/// but the last flies a gravity turn whose kick and azimuth are optimised; the
+/// last stage flies PEG to the target's periapsis, and the azimuth steers the
+/// inclination. Candidates are generated by differential evolution (rand/1/bin)
+/// and each generation is flown in parallel, one integrator per thread. The
+/// planet and vehicle are set up once and only copied per evaluation, so expensive
+/// models (gravity grids, ephemerides) are shared by every thread.
+class AscentOptimizer {
+public:
+    
+    struct Settings {
+        int         population = 24;
+        int         generations = 40;
+        double      differentialWeight = 0.7;
+        double      crossover = 0.9;
+        /// Integration step of each evaluation.
+        double      dt = 0.2;
+        /// Worker threads; 0 uses every hardware thread.
+        int         threads = 0;
+        unsigned    seed = 1;
+        /// Stops early once the whole population is within this many kg of the best.
+        double      tolerance = 1;
+        /// How often PEG re-solves on the upper stage.
+        double      pegPeriod = 2;
+    };
+    
+    struct Result {
+        AscentEvaluation    best;
+        int                 generations;
+        int                 evaluations;
+    };
+    
+    /// `vehicle` must be set on its launch pad; its guidance is replaced.
+    AscentOptimizer(const MassiveBody& planet, const Vehicle& vehicle, const Orbit& target,
+                    const Settings& settings);
+    AscentOptimizer(const MassiveBody& planet, const Vehicle& vehicle, const Orbit& target) :
+        AscentOptimizer(planet, vehicle, target, Settings()) {}
+    
+    Result optimize() const;
+    
+    /// Flies one candidate with the given integrator.
+    AscentEvaluation evaluate(const AscentParameters& parameters, Integrator& integrator) const;
+    
+    /// Search bounds of each parameter.
+    AscentParameters lower;
+    AscentParameters upper;
+    
+private:
+    
+    const MassiveBody&  _planet;
+    Vehicle             _vehicle;
+    Settings            _settings;
+    double              _targetPeriapsis;
+    double              _targetApoapsis;
+    double              _targetSemiMajorAxis;
+    double              _targetInclination;
+    double              _propellant;
+};
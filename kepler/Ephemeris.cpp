@@ -0,0 +1,111 @@
+//
+//  Ephemeris.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "Ephemeris.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+Ephemeris::Ephemeris(const std::string& file) {
+    std::ifstream raw{file};
+    if(!raw.is_open()) { throw std::runtime_error("Unable to open ephemeris " + file); }
+    
+    std::string line;
+    while(std::getline(raw, line)) {
+        if(line.empty() || line[0] == '#') { continue; }
+        std::istringstream fields{line};
+        double start, end;
+        int count;
+        if(!(fields >> start >> end >> count) || count < 1) {
+            throw std::runtime_error("Malformed ephemeris segment in " + file);
+        }
+        std::vector<double> axes[3];
+        for(auto& axis : axes) {
+            axis.resize(count);
+            for(auto& c : axis) {
+                if(!(fields >> c)) { throw std::runtime_error("Truncated ephemeris segment in " + file); }
+            }
+        }
+        addSegment(start, end, axes[0], axes[1], axes[2]);
+    }
+    if(_sizes.empty()) { throw std::runtime_error("Empty ephemeris " + file); }
+}
+
+Ephemeris Ephemeris::fit(const std::function<vec3(double)>& position,
+                         double start, double end, double span, int degree) {
+    Ephemeris ephemeris;
+    const int count = degree + 1;
+    std::vector<double> axes[3];
+    std::vector<vec3> samples(count);
+    
+    for(double t0 = start; t0 < end; t0 += span) {
+        double t1 = min(t0 + span, end);
+        for(int j = 0; j < count; ++j) {
+            double x = std::cos(M_PI * (j + 0.5) / count);
+            samples[j] = position(t0 + (x + 1.0) * 0.5 * (t1 - t0));
+        }
+        for(int a = 0; a < 3; ++a) {
+            axes[a].assign(count, 0);
+            for(int k = 0; k < count; ++k) {
+                double c = 0;
+                for(int j = 0; j < count; ++j) {
+                    c += samples[j].data[a] * std::cos(M_PI * k * (j + 0.5) / count);
+                }
+                axes[a][k] = c * (k == 0 ? 1.0 : 2.0) / count;
+            }
+        }
+        ephemeris.addSegment(t0, t1, axes[0], axes[1], axes[2]);
+    }
+    return ephemeris;
+}
+
+void Ephemeris::addSegment(double start, double end, const std::vector<double>& x,
+                           const std::vector<double>& y, const std::vector<double>& z) {
+    if(end <= start) { throw std::runtime_error("Ephemeris segment ends before it starts"); }
+    if(_bounds.empty()) {
+        _bounds.push_back(start);
+    } else if(start != _bounds.back()) {
+        throw std::runtime_error("Ephemeris segments must be sorted and contiguous");
+    }
+    _bounds.push_back(end);
+    _offsets.push_back(int(_coefficients.size()));
+    _sizes.push_back(int(x.size()));
+    for(std::size_t k = 0; k < x.size(); ++k) {
+        _coefficients.push_back(x[k]);
+        _coefficients.push_back(y[k]);
+        _coefficients.push_back(z[k]);
+    }
+}
+
+vec3 Ephemeris::position(double epoch) const {
+    if(epoch < start() || epoch > end()) { throw std::runtime_error("Epoch outside of ephemeris range"); }
+    auto it = std::upper_bound(_bounds.begin() + 1, _bounds.end() - 1, epoch);
+    int segment = int(it - (_bounds.begin() + 1));
+    
+    double t0 = _bounds[segment];
+    double t1 = _bounds[segment + 1];
+    double tau = 2.0 * (epoch - t0) / (t1 - t0) - 1.0;
+    const double* c = _coefficients.data() + _offsets[segment];
+    
+    vec3 b1{0}, b2{0};
+    for(int k = _sizes[segment] - 1; k >= 1; --k) {
+        vec3 b0{
+            c[3*k+0] + 2.0*tau*b1.x - b2.x,
+            c[3*k+1] + 2.0*tau*b1.y - b2.y,
+            c[3*k+2] + 2.0*tau*b1.z - b2.z
+        };
+        b2 = b1;
+        b1 = b0;
+    }
+    return vec3{
+        c[0] + tau*b1.x - b2.x,
+        c[1] + tau*b1.y - b2.y,
+        c[2] + tau*b1.z - b2.z
+    };
+}
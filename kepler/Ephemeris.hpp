@@ -0,0 +1,54 @@
+//
+//  Ephemeris.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "vec.hpp"
+
+/// Tabulated position of a body as a series of Chebyshev polynomial segments,
+/// in the style of the JPL development ephemerides. Positions are relative to the
+/// central body, in the simulation's inertial frame, and times are in seconds from
+/// the simulation's epoch.
+class Ephemeris final {
+public:
+    
+    /// Loads segments from a text file. Each non-comment (`#`) line holds one
+    /// segment: `start end n`, followed by n x coefficients, n y coefficients and
+    /// n z coefficients. Segments must be sorted and contiguous.
+    Ephemeris(const std::string& file);
+    
+    /// Builds a table by fitting `position` with degree `degree` polynomials on
+    /// segments of `span` seconds, covering [start, end].
+    static Ephemeris fit(const std::function<vec3(double)>& position,
+                         double start, double end, double span, int degree);
+    
+    /// Position at a given epoch, evaluated with Clenshaw's recurrence.
+    vec3 position(double epoch) const;
+    
+    double start() const { return _bounds.front(); }
+    
+    double end() const { return _bounds.back(); }
+    
+private:
+    
+    Ephemeris() {}
+    
+    void addSegment(double start, double end, const std::vector<double>& x,
+                    const std::vector<double>& y, const std::vector<double>& z);
+    
+    /// Segment boundaries: segment i covers [_bounds[i], _bounds[i+1]].
+    std::vector<double> _bounds;
+    /// Offset of each segment's first coefficient in `_coefficients`.
+    std::vector<int>    _offsets;
+    /// Number of coefficients per axis in each segment.
+    std::vector<int>    _sizes;
+    /// x, y and z coefficients interleaved, so one recurrence walks one array.
+    std::vector<double> _coefficients;
+};
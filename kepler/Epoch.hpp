@@ -0,0 +1,122 @@
+//
+//  Epoch.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+/// A point in time, in seconds from the simulation's reference epoch, held as a
+/// whole number of seconds and a fraction in [0, 1). A double holding the same time
+/// loses resolution as it grows (past a few days, every addition rounds to about a
+/// nanosecond); the fraction keeps its ~1e-16s resolution whatever the epoch.
+struct Epoch {
+
+    Epoch() : seconds(0), fraction(0) {}
+
+    /// Splits a time given in seconds.
+    explicit Epoch(double time) : Epoch(0, time) {}
+
+    /// Creates an epoch from whole seconds and a fraction of any size or sign.
+    Epoch(std::int64_t seconds, double fraction) : seconds(seconds), fraction(fraction) {
+        // Taking the integer part off a double is exact; the sum of a tiny negative
+        // fraction and 1 may round up to 1, which is carried again.
+        double whole = std::floor(this->fraction);
+        this->seconds += std::int64_t(whole);
+        this->fraction -= whole;
+        if(this->fraction >= 1) {
+            this->seconds += 1;
+            this->fraction -= 1;
+        }
+    }
+
+    /// The time as a plain number of seconds, for the APIs that take one.
+    double value() const { return double(seconds) + fraction; }
+
+    /// How far into a cycle of `period` seconds the epoch is, in [0, 1): the phase of
+    /// a body's rotation, without the rounding `value() / period` has at large epochs.
+    double phase(double period) const {
+        double r = std::fmod(double(seconds), period) + fraction;
+        if(r < 0) { r += period; }
+        if(r >= period) { r -= period; }
+        return r / period;
+    }
+
+    Epoch& operator+=(double dt) { return *this = Epoch(seconds, fraction + dt); }
+
+    Epoch& operator-=(double dt) { return *this = Epoch(seconds, fraction - dt); }
+
+    std::int64_t    seconds;
+    double          fraction;
+};
+
+inline Epoch
+operator+(const Epoch& lhs, double rhs) { return Epoch(lhs.seconds, lhs.fraction + rhs); }
+
+inline Epoch
+operator-(const Epoch& lhs, double rhs) { return Epoch(lhs.seconds, lhs.fraction - rhs); }
+
+/// Time between two epochs, in seconds.
+inline double
+operator-(const Epoch& lhs, const Epoch& rhs) {
+    return double(lhs.seconds - rhs.seconds) + (lhs.fraction - rhs.fraction);
+}
+
+inline bool
+operator==(const Epoch& lhs, const Epoch& rhs) { return lhs.seconds == rhs.seconds && lhs.fraction == rhs.fraction; }
+
+inline bool
+operator!=(const Epoch& lhs, const Epoch& rhs) { return !(lhs == rhs); }
+
+inline bool
+operator<(const Epoch& lhs, const Epoch& rhs) {
+    return lhs.seconds < rhs.seconds || (lhs.seconds == rhs.seconds && lhs.fraction < rhs.fraction);
+}
+
+inline bool
+operator>(const Epoch& lhs, const Epoch& rhs) { return rhs < lhs; }
+
+inline bool
+operator<=(const Epoch& lhs, const Epoch& rhs) { return !(rhs < lhs); }
+
+inline bool
+operator>=(const Epoch& lhs, const Epoch& rhs) { return !(lhs < rhs); }
+
+inline std::ostream&
+operator<<(std::ostream& s, const Epoch& e) { return s << e.value(); }
+
+/// Accumulates steps of any length into an epoch, with compensated summation: the
+/// rounding error of every addition is kept (Neumaier's variant of Kahan's
+/// algorithm) and folded back into the result. Millions of steps then add up to
+/// their exact total to within a few ulps of the fraction, where `t += dt` drifts by
+/// up to one rounding of `t` per step, and can take an extra, tiny last step out
+/// of a loop that should have ended.
+class Clock {
+public:
+
+    explicit Clock(const Epoch& start = Epoch()) : _start(start), _now(start), _compensation(0) {}
+
+    /// Moves the clock forward (or backwards) by `dt` seconds.
+    void advance(double dt) {
+        double a = _now.fraction;
+        double sum = a + dt;
+        _compensation += std::abs(a) >= std::abs(dt) ? (a - sum) + dt : (dt - sum) + a;
+        _now = Epoch(_now.seconds, sum);
+    }
+
+    /// The current epoch.
+    Epoch now() const { return Epoch(_now.seconds, _now.fraction + _compensation); }
+
+    /// Time elapsed since the clock started, in seconds.
+    double elapsed() const { return now() - _start; }
+
+private:
+    Epoch   _start;
+    Epoch   _now;
+    double  _compensation;
+};
@@ -0,0 +1,130 @@
+//
+//  ForceModel.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include "SolidBody.hpp"
+#include "MassiveBody.hpp"
+
+/// Everything the force models need about one evaluation, computed once per
+/// integrator stage and shared by every model of the pipeline. The state and the
+/// body's properties may use any scalar type; epochs stay in doubles.
+template <typename T>
+struct BasicStageContext {
+    
+    BasicStageContext(const BasicBodyProperties<T>& body, const MassiveBody& planet, const BasicState<T>& state,
+                      double epoch, int stage) :
+        BasicStageContext(body, planet, state, epoch, stage, body.mass) {}
+    
+    /// Evaluation for an integrated mass rather than the body's current one.
+    BasicStageContext(const BasicBodyProperties<T>& body, const MassiveBody& planet, const BasicState<T>& state,
+                      double epoch, int stage, const T& mass) :
+        body(body),
+        planet(planet),
+        state(state),
+        epoch(epoch),
+        stage(stage),
+        local(planet.localGeometry(state.p)),
+        density(planet.atmosphericDensity(local)),
+        airspeed(state.v - planet.inertialVelocity(local)),
+        speed(airspeed.magnitude()),
+        mass(mass) {}
+    
+    const BasicBodyProperties<T>&   body;
+    const MassiveBody&              planet;
+    BasicState<T>                   state;
+    double                          epoch;
+    /// Index of the stage epoch in the list given to ForceModel::prepare.
+    int                             stage;
+    
+    /// Position relative to the planet: ray, radius, altitude, local frame.
+    MassiveBody::BasicLocalGeometry<T>  local;
+    T                               density;
+    /// Velocity relative to the planet's atmosphere.
+    vec<T, 3>                       airspeed;
+    T                               speed;
+    T                               mass;
+};
+
+using StageContext = BasicStageContext<double>;
+
+/// Computes the total acceleration on a body. Integrators call `prepare` once
+/// per step with the distinct epochs their stages will be evaluated at, so that
+/// models can look up anything that only depends on time before the step starts.
+/// Models may keep per-step state: like integrators, each thread needs its own.
+class ForceModel {
+public:
+    virtual ~ForceModel() {}
+    
+    virtual void prepare(const MassiveBody& planet, const double* epochs, int count) = 0;
+    
+    virtual vec3 acceleration(const StageContext& context) const = 0;
+};
+
+/// Base for individual force terms without anything to prepare.
+struct ForceTerm {
+    void prepare(const MassiveBody&, const double*, int) {}
+};
+
+/// A pipeline of force terms composed at compile time. Each term is a plain
+/// object with `prepare` and `acceleration` members, called directly (and so
+/// inlined) for every term in order: only the pipeline itself costs a virtual call.
+/// Terms take a `BasicStageContext<T>` for any scalar type, so the same pipeline
+/// also integrates dual numbers and double-doubles, through the non-virtual
+/// `acceleration` template.
+template <typename... Terms>
+class Forces final : public ForceModel {
+public:
+    
+    Forces() {}
+    
+    Forces(const Terms&... terms) : _terms(terms...) {}
+    
+    virtual void prepare(const MassiveBody& planet, const double* epochs, int count) {
+        prepareTerms<0>(planet, epochs, count);
+    }
+    
+    virtual vec3 acceleration(const StageContext& context) const {
+        return sum<0>(context);
+    }
+    
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& context) const {
+        return sum<0>(context);
+    }
+    
+    /// Access to the I-th term.
+    template <std::size_t I>
+    typename std::tuple_element<I, std::tuple<Terms...>>::type& term() { return std::get<I>(_terms); }
+    
+private:
+    
+    template <std::size_t I, typename T>
+    typename std::enable_if<(I == sizeof...(Terms)), vec<T, 3>>::type
+    sum(const BasicStageContext<T>&) const { return vec<T, 3>(0); }
+    
+    template <std::size_t I, typename T>
+    typename std::enable_if<(I < sizeof...(Terms)), vec<T, 3>>::type
+    sum(const BasicStageContext<T>& context) const {
+        return std::get<I>(_terms).acceleration(context) + sum<I+1>(context);
+    }
+    
+    template <std::size_t I>
+    typename std::enable_if<(I == sizeof...(Terms))>::type
+    prepareTerms(const MassiveBody&, const double*, int) {}
+    
+    template <std::size_t I>
+    typename std::enable_if<(I < sizeof...(Terms))>::type
+    prepareTerms(const MassiveBody& planet, const double* epochs, int count) {
+        std::get<I>(_terms).prepare(planet, epochs, count);
+        prepareTerms<I+1>(planet, epochs, count);
+    }
+    
+    std::tuple<Terms...>    _terms;
+};
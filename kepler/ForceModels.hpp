@@ -0,0 +1,179 @@
+//
+//  ForceModels.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <memory>
+#include <vector>
+#include "ForceModel.hpp"
+
+/// The central body's gravity, including its non-spherical field if it has one.
+struct Gravity : ForceTerm {
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        return c.planet.gravity(c.local, c.epoch);
+    }
+};
+
+/// The central body's point-mass gravity alone, for pipelines that take the
+/// non-spherical part separately (see `FieldGravity`).
+struct CentralGravity : ForceTerm {
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        return c.planet.centralGravity(c.local);
+    }
+};
+
+/// The non-spherical part of the central body's gravity alone.
+struct FieldGravity : ForceTerm {
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        return c.planet.fieldGravity(c.local, c.epoch);
+    }
+};
+
+/// Aerodynamic drag, opposed to the velocity relative to the atmosphere.
+struct Drag : ForceTerm {
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        if(c.density == 0 || c.speed == 0) { return vec<T, 3>(0); }
+        T k = 0.5 * c.density * c.speed * c.body.surfaceArea * c.body.dragCoefficient;
+        return c.airspeed * (-k / c.mass);
+    }
+};
+
+/// Forces applied by the body itself (engines, mostly).
+struct Thrust : ForceTerm {
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        return c.body.forces / c.mass;
+    }
+};
+
+/// Perturbations from the planet's third bodies, sampled once per stage epoch.
+struct ThirdBodies {
+    
+    void prepare(const MassiveBody& planet, const double* epochs, int count) {
+        const auto& bodies = planet.thirdBodies();
+        _count = bodies.size();
+        _samples.resize(_count * count);
+        for(int stage = 0; stage < count; ++stage) {
+            for(std::size_t i = 0; i < _count; ++i) {
+                _samples[stage * _count + i] = bodies[i]->sample(epochs[stage]);
+            }
+        }
+    }
+    
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        vec<T, 3> a(0);
+        const auto& bodies = c.planet.thirdBodies();
+        const ThirdBody::Sample* samples = _samples.data() + c.stage * _count;
+        for(std::size_t i = 0; i < _count; ++i) {
+            a += bodies[i]->acceleration(samples[i], c.local.ray);
+        }
+        return a;
+    }
+    
+private:
+    std::size_t                     _count = 0;
+    std::vector<ThirdBody::Sample>  _samples;
+};
+
+/// Solar radiation pressure, if the planet has it enabled. The Sun's geometry is
+/// sampled once per stage epoch.
+struct RadiationPressure {
+    
+    void prepare(const MassiveBody& planet, const double* epochs, int count) {
+        _geometry.resize(count);
+        if(!planet.solarRadiation()) { return; }
+        for(int stage = 0; stage < count; ++stage) {
+            _geometry[stage] = planet.solarRadiation()->sample(epochs[stage], planet.radius());
+        }
+    }
+    
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        auto radiation = c.planet.solarRadiation();
+        if(!radiation) { return vec<T, 3>(0); }
+        return radiation->acceleration(_geometry[c.stage], c.local.ray, c.planet.radius(),
+                                       c.body.surfaceArea / c.mass, c.body.reflectivity);
+    }
+    
+private:
+    std::vector<SolarRadiation::Geometry>   _geometry;
+};
+
+/// Evaluates a slowly varying, expensive force term at a lower rate than the
+/// integrator's stages: `Term` is only evaluated once every `period` seconds of
+/// integrated time, and extrapolated linearly in time from its last two samples in
+/// between. Perturbations such as high-degree harmonics or third bodies change over
+/// minutes along an orbit, while thrust and drag need steps of a fraction of a
+/// second during an ascent: sampling them at their own rate saves most of their cost
+/// for an error that grows as the square of `period`. Terms that jump, such as
+/// radiation pressure in and out of eclipse, must not be sampled: extrapolating
+/// across the jump overshoots it.
+///
+/// Samples are only taken at the first stage of a step, which is on the trajectory;
+/// the other stages are trial states and only read the extrapolation. Samples follow
+/// one trajectory forward in time, so a pipeline with sampled terms must only
+/// integrate a single body. A jump in time of more than a period either way starts
+/// the sampling over. Only double trajectories are sampled: with other scalar types
+/// (derivatives, double-doubles), the term is evaluated at every stage.
+template <typename Term>
+class Sampled {
+public:
+    
+    Sampled(double period = 10, const Term& term = Term()) : _term(term), _period(period) {}
+    
+    void prepare(const MassiveBody& planet, const double* epochs, int count) {
+        _term.prepare(planet, epochs, count);
+    }
+    
+    template <typename T>
+    vec<T, 3> acceleration(const BasicStageContext<T>& c) const {
+        return _term.acceleration(c);
+    }
+    
+    vec3 acceleration(const StageContext& c) const {
+        if(_samples && (c.epoch < _time[1] - _period || c.epoch > _time[1] + 2 * _period)) {
+            _samples = 0;
+        }
+        if(c.stage == 0 && (!_samples || c.epoch >= _time[1] + _period)) {
+            auto a = _term.acceleration(c);
+            _time[0] = _time[1];
+            _value[0] = _value[1];
+            _time[1] = c.epoch;
+            _value[1] = a;
+            _samples = min(_samples + 1, 2);
+            return a;
+        }
+        if(!_samples) { return _term.acceleration(c); }
+        if(_samples == 1) { return _value[1]; }
+        return _value[1] + (_value[1] - _value[0]) * ((c.epoch - _time[1]) / (_time[1] - _time[0]));
+    }
+    
+    /// Forgets the samples, for a new trajectory.
+    void reset() { _samples = 0; }
+    
+    Term& term() { return _term; }
+    
+private:
+    Term            _term;
+    double          _period;
+    mutable int     _samples = 0;
+    mutable double  _time[2] = {0, 0};
+    mutable vec3    _value[2];
+};
+
+/// Every force model the simulator knows about.
+using StandardForces = Forces<Gravity, Drag, Thrust, ThirdBodies, RadiationPressure>;
+
+/// The standard forces, with the gravity field and third bodies sampled at a lower
+/// rate than the central gravity, drag, thrust and radiation pressure.
+using MultiRateForces = Forces<CentralGravity, Drag, Thrust, RadiationPressure,
+                               Sampled<FieldGravity>, Sampled<ThirdBodies>>;
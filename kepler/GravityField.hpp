@@ -0,0 +1,21 @@
+//
+//  GravityField.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include "vec.hpp"
+
+/// Non-spherical part of a body's gravity field. Fields are expressed in the
+/// body-fixed frame (z along the rotation axis, x through the prime meridian),
+/// and only return what has to be added to the point-mass term.
+class GravityField {
+public:
+    virtual ~GravityField() {}
+
+    /// Perturbing acceleration at a body-fixed position relative to the body's centre.
+    virtual vec3 perturbation(const vec3& at) const = 0;
+};
@@ -0,0 +1,124 @@
+//
+//  GravityGrid.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "GravityGrid.hpp"
+#include <stdexcept>
+
+GravityGrid::GravityGrid(std::shared_ptr<const GravityField> field,
+                         double innerRadius,
+                         double outerRadius,
+                         int radialCells,
+                         int latitudeCells,
+                         int longitudeCells) :
+_field(field),
+_innerRadius(innerRadius),
+_outerRadius(outerRadius),
+_cellsR(radialCells),
+_cellsLat(latitudeCells),
+_cellsLon(longitudeCells),
+_built(0)
+{
+    if(!field) { throw std::runtime_error("Gravity grid needs a source field"); }
+    if(innerRadius <= 0 || outerRadius <= innerRadius) {
+        throw std::runtime_error("Invalid gravity grid radius band");
+    }
+    if(radialCells < 1 || latitudeCells < 1 || longitudeCells < 1) {
+        throw std::runtime_error("Gravity grid needs at least one cell in every direction");
+    }
+
+    _tilesR = (_cellsR + tileSize - 1) / tileSize;
+    _tilesLat = (_cellsLat + tileSize - 1) / tileSize;
+    _tilesLon = (_cellsLon + tileSize - 1) / tileSize;
+
+    _dr = (_outerRadius - _innerRadius) / _cellsR;
+    _dlat = M_PI / _cellsLat;
+    _dlon = 2.0 * M_PI / _cellsLon;
+
+    _tiles.reset(new std::atomic<Tile*>[tileCount()]);
+    for(int i = 0; i < tileCount(); ++i) {
+        _tiles[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+GravityGrid::~GravityGrid() {
+    for(int i = 0; i < tileCount(); ++i) {
+        delete _tiles[i].load(std::memory_order_relaxed);
+    }
+}
+
+vec3 GravityGrid::perturbation(const vec3& at) const {
+    double r = at.magnitude();
+    if(r < _innerRadius || r >= _outerRadius) { return _field->perturbation(at); }
+
+    double fr = (r - _innerRadius) / _dr;
+    double flat = (std::asin(at.z / r) + 0.5*M_PI) / _dlat;
+    double flon = (std::atan2(at.y, at.x) + M_PI) / _dlon;
+
+    int cr = clamp(int(fr), 0, _cellsR - 1);
+    int clat = clamp(int(flat), 0, _cellsLat - 1);
+    int clon = clamp(int(flon), 0, _cellsLon - 1);
+    double tr = fr - cr;
+    double tlat = flat - clat;
+    double tlon = flon - clon;
+
+    const Tile* t = tile(cr / tileSize, clat / tileSize, clon / tileSize);
+    const int i = cr % tileSize;
+    const int j = clat % tileSize;
+    const int k = clon % tileSize;
+
+    auto node = [&](int di, int dj, int dk) -> const vec3& {
+        return t->nodes[((i + di) * tileNodes + (j + dj)) * tileNodes + (k + dk)];
+    };
+
+    vec3 result{0};
+    for(int di = 0; di < 2; ++di) {
+        double wr = di ? tr : 1 - tr;
+        for(int dj = 0; dj < 2; ++dj) {
+            double wlat = wr * (dj ? tlat : 1 - tlat);
+            result += node(di, dj, 0) * (wlat * (1 - tlon));
+            result += node(di, dj, 1) * (wlat * tlon);
+        }
+    }
+    return result;
+}
+
+const GravityGrid::Tile* GravityGrid::tile(int ir, int ilat, int ilon) const {
+    auto& slot = _tiles[(ir * _tilesLat + ilat) * _tilesLon + ilon];
+    Tile* existing = slot.load(std::memory_order_acquire);
+    if(existing) { return existing; }
+
+    // Two threads may race to fill the same tile: both build it, only the first
+    // one is published and the other copy is thrown away.
+    Tile* fresh = build(ir, ilat, ilon);
+    if(slot.compare_exchange_strong(existing, fresh, std::memory_order_acq_rel)) {
+        _built.fetch_add(1, std::memory_order_relaxed);
+        return fresh;
+    }
+    delete fresh;
+    return existing;
+}
+
+GravityGrid::Tile* GravityGrid::build(int ir, int ilat, int ilon) const {
+    auto tile = new Tile;
+    for(int i = 0; i < tileNodes; ++i) {
+        double r = _innerRadius + (ir * tileSize + i) * _dr;
+        for(int j = 0; j < tileNodes; ++j) {
+            double lat = -0.5*M_PI + (ilat * tileSize + j) * _dlat;
+            for(int k = 0; k < tileNodes; ++k) {
+                double lon = -M_PI + (ilon * tileSize + k) * _dlon;
+                vec3 at{
+                    r * std::cos(lat) * std::cos(lon),
+                    r * std::cos(lat) * std::sin(lon),
+                    r * std::sin(lat)
+                };
+                tile->nodes[(i * tileNodes + j) * tileNodes + k] = _field->perturbation(at);
+            }
+        }
+    }
+    return tile;
+}
@@ -0,0 +1,66 @@
+//
+//  GravityGrid.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "GravityField.hpp"
+
+/// Caches another gravity field on a radius/latitude/longitude grid, and answers
+/// queries by trilinear interpolation. The grid is split into tiles that are only
+/// filled the first time a query lands in them, so only the regions a trajectory
+/// actually visits are ever evaluated. Tiles are published atomically and never
+/// modified afterwards, which makes a single grid safe to share between threads.
+/// Positions outside of the grid's radius band fall back to the source field.
+class GravityGrid final : public GravityField {
+public:
+
+    GravityGrid(std::shared_ptr<const GravityField> field,
+                double innerRadius,
+                double outerRadius,
+                int radialCells,
+                int latitudeCells,
+                int longitudeCells);
+
+    ~GravityGrid();
+
+    GravityGrid(const GravityGrid&) = delete;
+    GravityGrid& operator=(const GravityGrid&) = delete;
+
+    virtual vec3 perturbation(const vec3& at) const;
+
+    /// Number of tiles that have been filled so far.
+    int tilesBuilt() const { return _built.load(std::memory_order_relaxed); }
+
+    /// Number of tiles the grid is split into.
+    int tileCount() const { return _tilesR * _tilesLat * _tilesLon; }
+
+private:
+
+    /// Cells along each side of a tile.
+    static const int tileSize = 8;
+    static const int tileNodes = tileSize + 1;
+
+    struct Tile {
+        vec3 nodes[tileNodes * tileNodes * tileNodes];
+    };
+
+    const Tile* tile(int ir, int ilat, int ilon) const;
+    Tile* build(int ir, int ilat, int ilon) const;
+
+    std::shared_ptr<const GravityField> _field;
+    double  _innerRadius;
+    double  _outerRadius;
+    int     _cellsR, _cellsLat, _cellsLon;
+    int     _tilesR, _tilesLat, _tilesLon;
+    double  _dr, _dlat, _dlon;
+
+    std::unique_ptr<std::atomic<Tile*>[]>   _tiles;
+    mutable std::atomic<int>                _built;
+};
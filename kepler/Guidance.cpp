@@ -0,0 +1,142 @@
+//
+//  Guidance.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "Guidance.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+GravityTurn::GravityTurn(double kickSpeed, double kickAngle, double azimuth, float throttle) :
+kickSpeed(kickSpeed),
+kickAngle(kickAngle),
+azimuth(azimuth),
+throttle(throttle),
+_cosKick(std::cos(kickAngle)),
+_sinKick(std::sin(kickAngle)),
+_cosAzimuth(std::cos(azimuth)),
+_sinAzimuth(std::sin(azimuth))
+{
+    
+}
+
+PitchProgram::PitchProgram(const std::vector<Point>& points, double azimuth, float throttle) :
+points(points),
+azimuth(azimuth),
+throttle(throttle)
+{
+    for(std::size_t i = 1; i < points.size(); ++i) {
+        if(points[i].time <= points[i-1].time) {
+            throw std::runtime_error("Pitch program points must be in increasing order of time");
+        }
+    }
+}
+
+Target PitchProgram::operator()(const MassiveBody& planet, const State& state, double met) const {
+    auto local = planet.localGeometry(state.p);
+    if(points.empty()) { return Target{local.up, throttle}; }
+    
+    auto next = std::upper_bound(points.begin(), points.end(), met,
+                                 [](double t, const Point& p) { return t < p.time; });
+    double pitch;
+    if(next == points.begin()) {
+        pitch = next->pitch;
+    } else if(next == points.end()) {
+        pitch = points.back().pitch;
+    } else {
+        auto previous = next - 1;
+        double t = (met - previous->time) / (next->time - previous->time);
+        pitch = previous->pitch + t * (next->pitch - previous->pitch);
+    }
+    
+    auto heading = local.north * std::cos(azimuth) + local.east * std::sin(azimuth);
+    return Target{local.up * std::cos(pitch) + heading * std::sin(pitch), throttle};
+}
+
+constexpr double PEG::terminalPhase;
+
+PEG::PEG(double targetRadius, double targetSemiMajorAxis, double thrust, double exhaustVelocity,
+         double updatePeriod, float throttle) :
+targetRadius(targetRadius),
+targetSemiMajorAxis(targetSemiMajorAxis),
+thrust(thrust),
+exhaustVelocity(exhaustVelocity),
+updatePeriod(updatePeriod),
+throttle(throttle)
+{
+    
+}
+
+void PEG::update(const MassiveBody& planet, const State& state, double met, double mass) {
+    const double mu = planet.gravitationalParameter();
+    const double ve = exhaustVelocity;
+    auto local = planet.localGeometry(state.p);
+    
+    double r = local.radius;
+    double vr = dot(state.v, local.up);
+    double vh = (state.v - local.up * vr).magnitude();
+    double rd = targetRadius;
+    double vd = std::sqrt(mu * (2 / rd - 1 / targetSemiMajorAxis));
+    
+    double a = thrust / mass;
+    double tau = ve / a;
+    double C = (mu / (r * r) - vh * vh / r) / a;
+    
+    // Start from the last solution, moved forward to now; a cold start needs a
+    // few more iterations to settle.
+    double T = _converged ? _timeToGo - (met - _updated) : 0.5 * tau;
+    double A = _A, B = _B;
+    int iterations = _converged ? 2 : 20;
+    bool valid = false;
+    
+    for(int i = 0; i < iterations; ++i) {
+        if(!(T > 0 && T < tau)) { break; }
+        
+        // Thrust integrals over the remaining burn.
+        double b0 = -ve * std::log(1 - T / tau);
+        double b1 = b0 * tau - ve * T;
+        double c0 = b0 * T - b1;
+        double c1 = c0 * tau - ve * T * T / 2;
+        
+        // Steering that brings the vertical speed to zero at the target radius.
+        double det = b0 * c1 - b1 * c0;
+        if(det == 0) { break; }
+        double dr = -vr;
+        double dz = rd - r - vr * T;
+        A = (c1 * dr - b1 * dz) / det;
+        B = (b0 * dz - c0 * dr) / det;
+        
+        // Time-to-go from the angular momentum still to be gained.
+        double aT = a / (1 - T / tau);
+        double CT = (mu / (rd * rd) - vd * vd / rd) / aT;
+        double fr = A + C;
+        double frT = A + B * T + CT;
+        double frDot = (frT - fr) / T;
+        double ft = 1 - fr * fr / 2;
+        double ftDot = -fr * frDot;
+        double ftDDot = -frDot * frDot / 2;
+        
+        double dh = rd * vd - r * vh;
+        double rMean = (r + rd) / 2;
+        double dv = dh / rMean + ve * T * (ftDot + ftDDot * tau) + ftDDot * ve * T * T / 2;
+        dv /= ft + ftDot * tau + ftDDot * tau * tau;
+        double next = tau * (1 - std::exp(-dv / ve));
+        
+        valid = std::isfinite(next) && std::isfinite(A) && std::isfinite(B) && next > 0;
+        if(!valid) { break; }
+        double change = std::abs(next - T);
+        T = next;
+        if(change < 0.1 && i > 0) { break; }
+    }
+    
+    // Keep flying the previous solution if this one did not work out.
+    if(!valid) { return; }
+    _A = A;
+    _B = B;
+    _timeToGo = T;
+    _updated = met;
+    _converged = true;
+}
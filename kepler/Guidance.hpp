@@ -0,0 +1,208 @@
+//
+//  Guidance.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <functional>
+#include <vector>
+#include "physics.hpp"
+#include "MassiveBody.hpp"
+#include "Orbit.hpp"
+
+/// What a guidance law asks of the engines: a thrust direction (inertial frame)
+/// and a throttle setting between 0 and 1.
+struct Target {
+    vec3 attitude;
+    float throttle;
+};
+
+/// Free-form guidance law: attitude and throttle from the vehicle's state, the
+/// mission elapsed time and the vehicle's current mass.
+using GNC = std::function<Target(const State&, double, double)>;
+
+/// Flies straight up until the vehicle reaches `kickSpeed` (relative to the
+/// atmosphere), pitches over by `kickAngle` towards `azimuth`, and then follows
+/// its surface-relative velocity once the trajectory has leaned over further.
+struct GravityTurn {
+    
+    GravityTurn(double kickSpeed, double kickAngle, double azimuth, float throttle = 1);
+    
+    Target operator()(const MassiveBody& planet, const State& state) const {
+        auto local = planet.localGeometry(state.p);
+        auto air = state.v - planet.inertialVelocity(local);
+        double speed = air.magnitude();
+        if(speed < kickSpeed) { return Target{local.up, throttle}; }
+        
+        auto prograde = air / speed;
+        if(dot(prograde, local.up) > _cosKick) {
+            auto heading = local.north * _cosAzimuth + local.east * _sinAzimuth;
+            return Target{local.up * _cosKick + heading * _sinKick, throttle};
+        }
+        return Target{prograde, throttle};
+    }
+    
+    double  kickSpeed;
+    double  kickAngle;
+    double  azimuth;
+    float   throttle;
+    
+private:
+    double  _cosKick, _sinKick;
+    double  _cosAzimuth, _sinAzimuth;
+};
+
+/// Pitch angle from the vertical scheduled against mission elapsed time, linearly
+/// interpolated between points and held past either end of the table.
+struct PitchProgram {
+    
+    struct Point {
+        double  time;
+        double  pitch;
+    };
+    
+    /// Points must be in increasing order of time.
+    PitchProgram(const std::vector<Point>& points, double azimuth, float throttle = 1);
+    
+    Target operator()(const MassiveBody& planet, const State& state, double met) const;
+    
+    std::vector<Point>  points;
+    double              azimuth;
+    float               throttle;
+};
+
+/// Powered Explicit Guidance: closed-loop, linear tangent steering that flies the
+/// stage to the periapsis of a target orbit, with the horizontal velocity needed
+/// there and no vertical velocity, and cuts the engine off when it gets there.
+/// The steering coefficients and time-to-go are only solved every `updatePeriod`
+/// seconds; in between, the commanded pitch follows the linear tangent law from
+/// the last solution, which is what the law would command anyway if the vehicle
+/// flew as predicted. Steering stays in the plane of the current trajectory.
+/// Each PEG keeps its last solution, so every vehicle needs its own copy: calling
+/// it updates that solution, and is not const.
+struct PEG {
+    
+    /// Targets insertion at `targetRadius` into an orbit of semi-major axis
+    /// `targetSemiMajorAxis`. `thrust` and `exhaustVelocity` are the stage's vacuum
+    /// performance.
+    PEG(double targetRadius, double targetSemiMajorAxis, double thrust, double exhaustVelocity,
+        double updatePeriod = 1, float throttle = 1);
+    
+    /// Targets insertion at the periapsis of `target`.
+    PEG(const Orbit& target, double thrust, double exhaustVelocity, double updatePeriod = 1, float throttle = 1) :
+        PEG(target.periapsis(), target.semiMajorAxis(), thrust, exhaustVelocity, updatePeriod, throttle) {}
+    
+    Target operator()(const MassiveBody& planet, const State& state, double met, double mass) {
+        if(_cutoff) { return Target{state.v, 0}; }
+        if(!_converged || (met - _updated >= updatePeriod && _timeToGo - (met - _updated) > terminalPhase)) {
+            update(planet, state, met, mass);
+        }
+        
+        auto local = planet.localGeometry(state.p);
+        double elapsed = met - _updated;
+        if(_converged && _timeToGo - elapsed <= cutoffTolerance) {
+            _cutoff = true;
+            return Target{state.v, 0};
+        }
+        
+        double vr = dot(state.v, local.up);
+        auto horizontal = state.v - local.up * vr;
+        double vh = horizontal.magnitude();
+        horizontal = vh > 0 ? horizontal / vh : local.east;
+        double C = (planet.gravitationalParameter() * local.inverseRadius * local.inverseRadius
+                    - vh * vh * local.inverseRadius) * mass / thrust;
+        double fr = clamp(_A + _B * elapsed + C, -1.0, 1.0);
+        return Target{local.up * fr + horizontal * std::sqrt(1 - fr * fr), throttle};
+    }
+    
+    /// Whether the engine has been cut off on reaching the target.
+    bool cutoff() const { return _cutoff; }
+    
+    /// Time left until cutoff, as of the last update.
+    double timeToGo() const { return _timeToGo; }
+    
+    /// Time left until cutoff at mission elapsed time `met`, or infinity before the
+    /// first solution and after cutoff. Integrators clip their steps to it, so that
+    /// the engine stops where the law says rather than at the next step boundary.
+    double timeToCutoff(double met) const {
+        if(!_converged || _cutoff) { return INFINITY; }
+        return max(_timeToGo - (met - _updated), 0.0);
+    }
+    
+    /// Close to cutoff the solution becomes ill-conditioned, and is no longer updated.
+    static constexpr double terminalPhase = 5;
+    
+    /// How close to the predicted cutoff the engine is stopped: a step clipped to
+    /// `timeToCutoff` lands within rounding of it.
+    static constexpr double cutoffTolerance = 1e-6;
+    
+    double  targetRadius;
+    double  targetSemiMajorAxis;
+    double  thrust;
+    double  exhaustVelocity;
+    double  updatePeriod;
+    float   throttle;
+    
+private:
+    
+    void update(const MassiveBody& planet, const State& state, double met, double mass);
+    
+    double  _A = 0, _B = 0;
+    double  _timeToGo = 0;
+    double  _updated = 0;
+    bool    _converged = false;
+    bool    _cutoff = false;
+};
+
+/// A stage's guidance. The laws kepler knows about are stored by value and
+/// dispatched with a switch, so their code can be inlined into the vehicle's
+/// step; anything else goes through a `GNC` std::function, which costs an
+/// indirect call per step. Default guidance flies straight up at full throttle.
+/// Laws with state of their own (PEG) update it when called, so a Guidance
+/// belongs to one vehicle at a time.
+class Guidance {
+public:
+    
+    enum class Law {
+        none,
+        gravityTurn,
+        pitchProgram,
+        peg,
+        custom,
+    };
+    
+    Guidance() : _law(Law::none) {}
+    Guidance(const GravityTurn& turn) : _law(Law::gravityTurn), _turn(turn) {}
+    Guidance(const PitchProgram& program) : _law(Law::pitchProgram), _program(program) {}
+    Guidance(const PEG& peg) : _law(Law::peg), _peg(peg) {}
+    Guidance(const GNC& custom) : _law(custom ? Law::custom : Law::none), _custom(custom) {}
+    
+    Law law() const { return _law; }
+    
+    Target operator()(const MassiveBody& planet, const State& state, double met, double mass) {
+        switch(_law) {
+        case Law::gravityTurn:  return _turn(planet, state);
+        case Law::pitchProgram: return _program(planet, state, met);
+        case Law::peg:          return _peg(planet, state, met, mass);
+        case Law::custom:       return _custom(state, met, mass);
+        case Law::none:         break;
+        }
+        return Target{planet.localGeometry(state.p).up, 1};
+    }
+    
+    /// Time left until the law cuts the engine off, or infinity if it has no such plan.
+    double timeToCutoff(double met) const {
+        return _law == Law::peg ? _peg.timeToCutoff(met) : INFINITY;
+    }
+    
+private:
+    
+    Law             _law;
+    GravityTurn     _turn{0, 0, 0};
+    PitchProgram    _program{{}, 0};
+    PEG             _peg{0, 0, 0, 0};
+    GNC             _custom;
+};
@@ -16,6 +16,19 @@ public:
     
     virtual ~Integrator() {}
     
-    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double dt) = 0;
+    /// Integrates the body's state from `epoch` to `epoch + dt`.
+    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt) = 0;
+    
+    /// Integrates position, velocity and mass together from `epoch` to `epoch + dt`,
+    /// the mass changing at a constant `massRate` (negative while burning). Forces
+    /// are evaluated with the mass at each stage rather than the body's `mass()`.
+    virtual MassState advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                                   const MassState& state, double massRate) = 0;
+    
+    /// Integrates the body's state from `epoch` to `epoch + dt`, and its state
+    /// transition matrix along with it: `transition` holds d(state)/d(initial state)
+    /// at `epoch` on input, and at `epoch + dt` on output (position rows first).
+    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                               mat66& transition) = 0;
 };
 
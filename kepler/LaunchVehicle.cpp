@@ -7,3 +7,106 @@
 //
 
 #include "LaunchVehicle.hpp"
+
+Vehicle::Vehicle(const std::vector<Stage>& stages,
+                 double payloadMass,
+                 double area,
+                 double dragCoefficient,
+                 double reflectivity) :
+_stages(stages),
+_active(0),
+_payloadMass(payloadMass),
+_area(area),
+_dragCoefficient(dragCoefficient),
+_reflectivity(reflectivity),
+_time(0),
+_throttle(0),
+_thrust(0),
+_lastTarget(0),
+_lastStep(0),
+_substeps(0)
+{
+    
+}
+
+void Vehicle::setRigidBody(std::shared_ptr<const RigidBody> body, const Attitude& attitude) {
+    _rigidBody = body;
+    _attitude = attitude;
+    _lastTarget = vec3{0.0};
+}
+
+double Vehicle::mass() const {
+    double mass = _payloadMass;
+    for(std::size_t i = _active; i < _stages.size(); ++i) {
+        mass += _stages[i].dryMass + _stages[i].propellantMass;
+    }
+    return mass;
+}
+
+void Vehicle::step(Integrator& integrator, const MassiveBody& planet, double epoch, double dt) {
+    double remaining = dt;
+    
+    while(remaining > 0) {
+        if(!burning()) {
+            _thrust = vec3{0};
+            _throttle = 0;
+            if(_rigidBody) {
+                auto free = [](const Attitude&) { return vec3{0.0}; };
+                _attitude = _rigidBody->advance(_attitude, mass(), remaining, free, 0, &_substeps);
+            }
+            _state = integrator.advanceState(*this, planet, epoch, remaining);
+            _time += remaining;
+            return;
+        }
+        
+        auto& stage = _stages[_active];
+        auto local = planet.localGeometry(_state.p);
+        auto target = stage.guidance(planet, _state, _time, mass());
+        double throttle = clamp(double(target.throttle), 0.0, 1.0);
+        _throttle = throttle;
+        double flow = stage.engine.mDot * throttle;
+        
+        // Cut the step short if the stage burns out during it, or if guidance plans
+        // to cut the engine off before its end: the next step then starts at cutoff.
+        double slice = min(remaining, stage.guidance.timeToCutoff(_time));
+        bool burnout = flow > 0 && stage.propellantMass <= flow * slice;
+        if(burnout) {
+            slice = stage.propellantMass / flow;
+        }
+        
+        auto direction = target.attitude.normalize();
+        if(_rigidBody) {
+            // Turn rate of the target, from its last two directions within the stage.
+            vec3 turnRate{0.0};
+            if(_lastTarget.magnitude() > 0 && _lastStep > 0) {
+                turnRate = vec3::cross(_lastTarget, direction) / _lastStep;
+            }
+            _lastTarget = direction;
+            _lastStep = slice;
+            
+            auto before = _attitude.orientation;
+            _attitude = _rigidBody->track(_attitude, mass(), slice, direction, turnRate, &_substeps);
+            // Mid-step orientation: the half-way slerp, which is the normalised sum.
+            auto middle = dot(before, _attitude.orientation) < 0 ? _attitude.orientation + -before
+                                                                  : _attitude.orientation + before;
+            direction = middle.normalize().rotate(RigidBody::thrustAxis());
+        }
+        _thrust = direction * (stage.engine.thrust(planet.atmospheres(local)) * throttle);
+        // Mass is integrated with the motion, so thrust and drag see it decrease
+        // through the step rather than holding its value at the start.
+        double start = mass();
+        auto next = integrator.advanceState(*this, planet, epoch, slice, MassState(_state, start), -flow);
+        _state = next.motion();
+        stage.propellantMass = burnout ? 0 : max(stage.propellantMass - (start - next.mass()), 0.0);
+        
+        _time += slice;
+        epoch += slice;
+        remaining -= slice;
+        
+        if(stage.propellantMass <= 0) {
+            _events.push_back(StagingEvent{_active, _time, _state});
+            _active += 1;
+            _lastTarget = vec3{0.0};
+        }
+    }
+}
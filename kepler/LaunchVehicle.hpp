@@ -7,10 +7,13 @@
 //
 
 #pragma once
+#include <memory>
 #include <vector>
-#include <functional>
 #include "physics.hpp"
+#include "RigidBody.hpp"
 #include "utils.hpp"
+#include "Integrator.hpp"
+#include "Guidance.hpp"
 
 struct Engine {
     Engine(double maxThrust, double slIsp, double vacIsp) {
@@ -32,25 +35,115 @@ struct Engine {
     double thrustCurve[2];
 };
 
-struct Target {
-    vec3 attitude;
-    float throttle;
-};
-
-using GNC = std::function<Target(const State&, double, double)>;
-
 struct Stage {
     double dryMass;
     double propellantMass;
     Engine engine;
-    GNC guidance;
+    Guidance guidance;
     
     double burnTime() const {
         return this->propellantMass / engine.mDot;
     }
 };
 
-class Vehicle {
-    std::vector<Stage> stages;
+/// Record of a stage separation.
+struct StagingEvent {
+    /// Index of the stage that was dropped.
+    int     stage;
+    /// Mission elapsed time at separation.
+    double  time;
+    State   state;
+};
+
+/// A multi-stage launch vehicle. Stages burn bottom first (`stages[0]`), and are
+/// dropped the moment their propellant runs out, igniting the next one. Steps are
+/// split at burnouts so that staging happens at the right time whatever the step
+/// size. The active stage's guidance is asked for an attitude and throttle once
+/// per step, which then hold for the whole step.
+///
+/// By default the vehicle is a point mass that instantly takes the attitude it is
+/// asked for. Given a `RigidBody`, it flies in six degrees of freedom instead: the
+/// attitude controller turns the vehicle towards the guidance target (and at the
+/// rate it turned at since the previous step), the rotation
+/// is sub-stepped inside each translational step, and thrust follows the vehicle's
+/// thrust axis at mid-step.
+class Vehicle final : public SolidBody {
+public:
+    
+    Vehicle(const std::vector<Stage>& stages,
+            double payloadMass,
+            double area,
+            double dragCoefficient,
+            double reflectivity = 1.3);
+    
+    virtual ~Vehicle() {}
+    
+    /// Flies the vehicle from `epoch` to `epoch + dt`.
+    void step(Integrator& integrator, const MassiveBody& planet, double epoch, double dt);
+    
+    void setState(const State& state) { _state = state; }
+    
+    virtual State stateVectors() const { return _state; }
+    
+    virtual double mass() const;
+    
+    virtual vec3 forces() const { return _thrust; }
+    
+    virtual double dragCoefficient() const { return _dragCoefficient; }
+    
+    virtual double surfaceArea() const { return _area; }
+    
+    virtual double reflectivity() const { return _reflectivity; }
+    
+    /// Index of the stage currently firing; equal to the number of stages once
+    /// every stage has been dropped.
+    int activeStage() const { return _active; }
+    
+    bool burning() const { return _active < int(_stages.size()); }
+    
+    /// Throttle commanded by guidance for the last step.
+    double throttle() const { return _throttle; }
+    
+    const Stage& stage(int index) const { return _stages[index]; }
+    
+    int stageCount() const { return int(_stages.size()); }
+    
+    void setGuidance(int stage, const Guidance& guidance) { _stages[stage].guidance = guidance; }
+    
+    double missionTime() const { return _time; }
+    
+    const std::vector<StagingEvent>& events() const { return _events; }
+    
+    /// Switches the vehicle to six degrees of freedom, starting from `attitude`.
+    /// Passing a null body switches back to a point mass.
+    void setRigidBody(std::shared_ptr<const RigidBody> body, const Attitude& attitude = Attitude());
+    
+    bool rigid() const { return bool(_rigidBody); }
+    
+    /// Orientation and angular velocity; only integrated in six degrees of freedom.
+    const Attitude& attitude() const { return _attitude; }
+    
+    /// Number of rotational sub-steps taken so far.
+    int attitudeSubsteps() const { return _substeps; }
+    
+private:
+    
+    std::vector<Stage>          _stages;
+    std::vector<StagingEvent>   _events;
+    int                         _active;
+    double                      _payloadMass;
+    double                      _area;
+    double                      _dragCoefficient;
+    double                      _reflectivity;
+    double                      _time;
+    double                      _throttle;
+    State                       _state;
+    vec3                        _thrust;
+    std::shared_ptr<const RigidBody>    _rigidBody;
+    Attitude                    _attitude;
+    /// Guidance direction of the previous step, zero at the start of a stage.
+    vec3                        _lastTarget;
+    double                      _lastStep;
+    int                         _substeps;
 };
 
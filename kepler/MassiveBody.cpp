@@ -7,6 +7,7 @@
 //
 
 #include "MassiveBody.hpp"
+#include "quaternion.hpp"
 #include "json.hpp"
 #include <fstream>
 #include <stdexcept>
@@ -20,7 +21,7 @@ MassiveBody::MassiveBody(const std::string& name,
                            double rho_0,
                            double atmo_scale_h,
                            double atmo_h) :
-name(name),
+_name(name),
 _rotationPeriod(period),
 _position(0, 0),
 _radius(radius),
@@ -39,9 +40,63 @@ MassiveBody::MassiveBody(const std::string& json_file) {
 }
 
 
-vec3 MassiveBody::gravity(const vec3& at) const {
-    double radius = (_position - at).magnitude();
-    return (_position - at).normalize((_gravitationalParameter) / (radius*radius));
+vec3 MassiveBody::gravity(const vec3& at, double epoch) const {
+    auto ray = at - _position;
+    double r2 = dot(ray, ray);
+    auto g = ray * (-_gravitationalParameter / (r2 * std::sqrt(r2)));
+    if(!_field) { return g; }
+    return g + perturbation(ray, epoch);
+}
+
+mat33 MassiveBody::gravityGradient(const LocalGeometry& local) const {
+    // -mu/r^3 (I - 3 u u^T), u being the local vertical.
+    double k = -_gravitationalParameter * local.inverseRadius * local.inverseRadius * local.inverseRadius;
+    mat33 gradient;
+    for(int i = 0; i < 3; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            gradient[i][j] = k * ((i == j ? 1 : 0) - 3 * local.up.data[i] * local.up.data[j]);
+        }
+    }
+    return gradient;
+}
+
+MassiveBody::DragPartials MassiveBody::dragPartials(const LocalGeometry& local, const vec3& velocity,
+                                                    double ballistic) const {
+    DragPartials partials;
+    double density = atmosphericDensity(local);
+    auto airspeed = velocity - inertialVelocity(local);
+    double speed = airspeed.magnitude();
+    if(density == 0 || speed == 0) { return partials; }
+    
+    // a = -k |va| va, with k = rho.B/2 and va = v - w x r:
+    //   da/dv = -k (|va| I + va va^T / |va|)
+    //   da/dr = -da/dv [w x] + (k |va| / H) va u^T, density falling off along u.
+    double k = 0.5 * density * ballistic;
+    double omega = (2.0*M_PI)/_rotationPeriod;
+    for(int i = 0; i < 3; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            partials.velocity[i][j] = -k * ((i == j ? speed : 0) + airspeed.data[i] * airspeed.data[j] / speed);
+        }
+    }
+    for(int i = 0; i < 3; ++i) {
+        // [w x] only has -omega at (0, 1) and omega at (1, 0).
+        partials.position[i][0] = -partials.velocity[i][1] * omega;
+        partials.position[i][1] = partials.velocity[i][0] * omega;
+        partials.position[i][2] = 0;
+        for(int j = 0; j < 3; ++j) {
+            partials.position[i][j] += k * speed / _atomsphere.scaleHeight * airspeed.data[i] * local.up.data[j];
+        }
+    }
+    return partials;
+}
+
+vec3 MassiveBody::perturbation(const vec3& ray, double epoch) const {
+    // Bring the position into the body-fixed frame, and the perturbation back out.
+    double theta = 2.0 * M_PI * (epoch / _rotationPeriod);
+    double s = std::sin(theta);
+    double c = std::cos(theta);
+    auto p = _field->perturbation(vec3{c*ray.x + s*ray.y, -s*ray.x + c*ray.y, ray.z});
+    return vec3{c*p.x - s*p.y, s*p.x + c*p.y, p.z};
 }
 
 vec3 MassiveBody::up(const vec3& at) const {
@@ -49,34 +104,46 @@ vec3 MassiveBody::up(const vec3& at) const {
 }
 
 vec3 MassiveBody::north(const vec3 &at) const {
-    return vec3::cross(up(at), east(at)).normalize();
+    return localGeometry(at).north;
 }
 
 vec3 MassiveBody::east(const vec3 &at) const {
-    return vec3::cross(vec3{0, 0, 1}, up(at)).normalize();
+    return localGeometry(at).east;
 }
 
 vec3 MassiveBody::heading(const vec3& at, double heading, double pitch) const {
-    return north(at).rotate(east(at), radians(pitch)).rotate(up(at), -radians(heading));
+    return this->heading(localGeometry(at), heading, pitch);
+}
+
+vec3 MassiveBody::heading(const LocalGeometry& local, double heading, double pitch) const {
+    // Pitch up around east, then turn around up: one composed rotation, applied once.
+    auto attitude = quat::axisAngle(local.up, -radians(heading)) * quat::axisAngle(local.east, radians(pitch));
+    return attitude.rotate(local.north);
 }
 
 vec3 MassiveBody::inertialVelocity(const vec3& at) const {
-    double from_axis = (at - _position).xy.magnitude();
+    auto ray = at - _position;
     double angular_velocity = (2.0*M_PI)/_rotationPeriod;
-    return east(at) * from_axis * angular_velocity;
+    return vec3{-ray.y, ray.x, 0} * angular_velocity;
 }
 
 MassiveBody::coordinates MassiveBody::polar(const vec3 &at, double epoch) const {
+    double days = 0;
+    return polarAt(at, epoch != 0 ? std::modf(epoch / _rotationPeriod, &days) : 0);
+}
+
+MassiveBody::coordinates MassiveBody::polar(const vec3 &at, const Epoch& epoch) const {
+    return polarAt(at, epoch.phase(_rotationPeriod));
+}
+
+MassiveBody::coordinates MassiveBody::polarAt(const vec3 &at, double turn) const {
     auto ray = at - _position;
     
     double longitude = degrees(std::atan2(ray.y, ray.x));
     double latitude = degrees(std::asin(at.z / ray.magnitude()));
     
-    if(epoch != 0) {
-        double when = epoch / _rotationPeriod;
-        double days = 0;
-        double fract = std::modf(when, &days) * 360.0;
-        longitude -= fract;
+    if(turn != 0) {
+        longitude -= turn * 360.0;
         longitude = (longitude < -180.0) ? 360.0 + longitude : longitude;
         longitude = (longitude > 180.0) ? longitude - 360.0 : longitude;
     }
@@ -104,7 +171,15 @@ double MassiveBody::altitude(const vec3 &at) const  {
 }
 
 double MassiveBody::atmosphericDensity(const vec3 &at) const  {
-    auto h = altitude(at);
-    if(h > _atomsphere.depth) return 0;
-    return _atomsphere.groundDensity * std::pow(M_E, -(h/_atomsphere.scaleHeight));
+    return densityAt(altitude(at));
+}
+
+double MassiveBody::atmospheres(const vec3 &at) const {
+    if(_atomsphere.groundDensity == 0) return 0;
+    return atmosphericDensity(at) / _atomsphere.groundDensity;
+}
+
+double MassiveBody::atmospheres(const LocalGeometry &local) const {
+    if(_atomsphere.groundDensity == 0) return 0;
+    return atmosphericDensity(local) / _atomsphere.groundDensity;
 }
@@ -7,8 +7,16 @@
 //
 
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 #include "vec.hpp"
+#include "Epoch.hpp"
+#include "dual.hpp"
+#include "ddouble.hpp"
+#include "GravityField.hpp"
+#include "ThirdBody.hpp"
+#include "SolarRadiation.hpp"
 
 /// Defines the way planets are represented in the integrator/universe
 /// Atmospheres are, so far, modeled using the basic
@@ -20,6 +28,31 @@ struct MassiveBody final {
         double altitude;
     };
     
+    /// Everything about a position relative to the body, worked out once so that
+    /// the queries below do not have to normalise the same ray again and again.
+    template <typename T>
+    struct BasicLocalGeometry {
+        /// Position relative to the body's centre.
+        vec<T, 3>   ray;
+        T           radius;
+        T           inverseRadius;
+        /// Distance from the rotation axis.
+        T           axisDistance;
+        T           altitude;
+        vec<T, 3>   up;
+        vec<T, 3>   east;
+        vec<T, 3>   north;
+    };
+    
+    using LocalGeometry = BasicLocalGeometry<double>;
+    
+    /// Local geometry at a position. This and the queries that take a local geometry
+    /// work for any scalar type, which is how the force models run in dual numbers
+    /// and double-doubles: parts that only exist in doubles (the
+    /// non-spherical field) are evaluated on the values, as constants.
+    template <typename T>
+    BasicLocalGeometry<T> localGeometry(const vec<T, 3>& at) const;
+    
     MassiveBody(const std::string& name,
                  double period,
                  double radius,
@@ -36,14 +69,60 @@ struct MassiveBody final {
     /// Get Lat/Lon/Alt from cartesian coordinates.
     coordinates polar(const vec3& at, double epoch = 0) const;
     
+    /// Get Lat/Lon/Alt from cartesian coordinates, at an epoch of any size: the
+    /// body's rotation angle keeps its precision however long the simulation runs.
+    coordinates polar(const vec3& at, const Epoch& epoch) const;
+    
     /// Get cartesian coordinates based on Lat/Lon/Alt
     vec3 cartesian(const coordinates& at) const;
     
     /// Returns the surface velocity
     vec3 inertialVelocity(const vec3& at) const;
     
-    /// Local gravity force exerted by the body.
-    vec3 gravity(const vec3& at) const;
+    template <typename T>
+    vec<T, 3> inertialVelocity(const BasicLocalGeometry<T>& local) const;
+    
+    /// Local gravity force exerted by the body. The epoch is only used to orient
+    /// the non-spherical part of the field, when there is one.
+    vec3 gravity(const vec3& at, double epoch = 0) const;
+    
+    template <typename T>
+    vec<T, 3> gravity(const BasicLocalGeometry<T>& local, double epoch = 0) const;
+    
+    /// Point-mass part of the body's gravity.
+    template <typename T>
+    vec<T, 3> centralGravity(const BasicLocalGeometry<T>& local) const;
+    
+    /// Non-spherical part of the body's gravity; zero without a gravity field.
+    template <typename T>
+    vec<T, 3> fieldGravity(const BasicLocalGeometry<T>& local, double epoch) const;
+    
+    /// Derivative of the central gravity term with respect to position.
+    mat33 gravityGradient(const LocalGeometry& local) const;
+    
+    /// Derivatives of the drag acceleration with respect to position and velocity.
+    struct DragPartials {
+        mat33   position;
+        mat33   velocity;
+    };
+    
+    /// Drag partials for a body of ballistic coefficient Cd·A/m `ballistic`.
+    DragPartials dragPartials(const LocalGeometry& local, const vec3& velocity, double ballistic) const;
+    
+    /// Attach a non-spherical gravity field, expressed in the body-fixed frame.
+    void setGravityField(std::shared_ptr<const GravityField> field) { _field = field; }
+    
+    const GravityField* gravityField() const { return _field.get(); }
+    
+    /// Add a distant body (Sun, Moon...) whose pull perturbs orbits around this one.
+    void addThirdBody(std::shared_ptr<const ThirdBody> body) { _thirdBodies.push_back(body); }
+    
+    const std::vector<std::shared_ptr<const ThirdBody>>& thirdBodies() const { return _thirdBodies; }
+    
+    /// Enable solar radiation pressure, with this body casting the shadow.
+    void setSolarRadiation(std::shared_ptr<const SolarRadiation> radiation) { _radiation = radiation; }
+    
+    const SolarRadiation* solarRadiation() const { return _radiation.get(); }
     
     /// Local vertical relative to the body.
     vec3 up(const vec3& at) const;
@@ -54,12 +133,25 @@ struct MassiveBody final {
     
     vec3 heading(const vec3& at, double heading, double pitch) const;
     
+    vec3 heading(const LocalGeometry& local, double heading, double pitch) const;
+    
     /// Altitude relative to the body.
     double altitude(const vec3& at) const;
     
     /// Atmospheric density at the current position.
     double atmosphericDensity(const vec3& at) const;
     
+    template <typename T>
+    T atmosphericDensity(const BasicLocalGeometry<T>& local) const { return densityAt(local.altitude); }
+    
+    /// Ambient pressure, in fractions of the pressure at ground level. The atmosphere
+    /// is isothermal, so this is also the ratio of densities.
+    double atmospheres(const vec3& at) const;
+    
+    double atmospheres(const LocalGeometry& local) const;
+    
+    const std::string& name() const { return _name; }
+    
     double gravitationalParameter() const { return _gravitationalParameter; }
     
     double radius() const { return _radius; }
@@ -68,7 +160,22 @@ struct MassiveBody final {
     
 private:
     
-    std::string name;
+    /// Lat/Lon/Alt once the body has turned by `turn` (in revolutions) since epoch 0.
+    coordinates polarAt(const vec3& at, double turn) const;
+    
+    /// Atmospheric density at a given altitude.
+    template <typename T>
+    T densityAt(const T& altitude) const;
+    
+    /// Non-spherical part of the field, rotated into the inertial frame.
+    vec3 perturbation(const vec3& ray, double epoch) const;
+    
+    template <typename T>
+    vec<T, 3> perturbation(const vec<T, 3>& ray, double epoch) const {
+        return constantVectorOf(ray, [&](const vec3& r) { return perturbation(r, epoch); });
+    }
+    
+    std::string _name;
     double      _rotationPeriod;
     vec3        _position;
     double      _radius;
@@ -82,6 +189,57 @@ private:
         double scaleHeight;
         double depth;
     }           _atomsphere;
+    std::shared_ptr<const GravityField> _field;
+    std::vector<std::shared_ptr<const ThirdBody>> _thirdBodies;
+    std::shared_ptr<const SolarRadiation> _radiation;
     
 };
 
+template <typename T>
+MassiveBody::BasicLocalGeometry<T> MassiveBody::localGeometry(const vec<T, 3>& at) const {
+    BasicLocalGeometry<T> local;
+    local.ray = at - vec<T, 3>(_position);
+    local.radius = local.ray.magnitude();
+    local.inverseRadius = 1.0 / local.radius;
+    local.axisDistance = local.ray.xy.magnitude();
+    local.altitude = local.radius - _radius;
+    local.up = local.ray * local.inverseRadius;
+    // East is the rotation axis crossed with up, which is already a unit vector
+    // once divided by the distance to the axis; so is north, made of the two.
+    local.east = (local.axisDistance > 0)
+        ? vec<T, 3>(-local.ray.y / local.axisDistance, local.ray.x / local.axisDistance, T(0))
+        : vec<T, 3>(0);
+    local.north = vec<T, 3>::cross(local.up, local.east);
+    return local;
+}
+
+template <typename T>
+vec<T, 3> MassiveBody::inertialVelocity(const BasicLocalGeometry<T>& local) const {
+    double angular_velocity = (2.0*M_PI)/_rotationPeriod;
+    return vec<T, 3>(-local.ray.y, local.ray.x, T(0)) * angular_velocity;
+}
+
+template <typename T>
+vec<T, 3> MassiveBody::gravity(const BasicLocalGeometry<T>& local, double epoch) const {
+    auto g = centralGravity(local);
+    if(!_field) { return g; }
+    return g + perturbation(local.ray, epoch);
+}
+
+template <typename T>
+vec<T, 3> MassiveBody::centralGravity(const BasicLocalGeometry<T>& local) const {
+    return local.up * (-_gravitationalParameter * local.inverseRadius * local.inverseRadius);
+}
+
+template <typename T>
+vec<T, 3> MassiveBody::fieldGravity(const BasicLocalGeometry<T>& local, double epoch) const {
+    if(!_field) { return vec<T, 3>(0); }
+    return perturbation(local.ray, epoch);
+}
+
+template <typename T>
+T MassiveBody::densityAt(const T& h) const {
+    using std::exp;
+    if(h > _atomsphere.depth) return 0;
+    return _atomsphere.groundDensity * exp(-(h/_atomsphere.scaleHeight));
+}
@@ -0,0 +1,201 @@
+//
+//  NBody.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "NBody.hpp"
+#include "PlanetarySystem.hpp"
+
+/// Coincident bodies stop subdividing at this depth and share a leaf.
+static const int maxDepth = 48;
+/// Bodies a leaf holds before it is split. Small buckets are cheaper to sum
+/// directly than to walk as separate cells.
+static const int leafSize = 8;
+
+NBody NBody::fromSystem(const PlanetarySystem& system, double epoch) {
+    NBody nbody;
+    for(int i = 0; i < system.size(); ++i) {
+        nbody.add(system.stateVectors(i, epoch), system.body(i).gravitationalParameter());
+    }
+    return nbody;
+}
+
+int NBody::add(const State& state, double mu) {
+    _positions.push_back(state.p);
+    _velocities.push_back(state.v);
+    _mu.push_back(mu);
+    if(mu > 0) { _massive.push_back(size() - 1); }
+    _accelerationsValid = false;
+    return size() - 1;
+}
+
+void NBody::step(double dt) {
+    const int n = size();
+    if(!_accelerationsValid) {
+        accelerations(_accelerations);
+        _accelerationsValid = true;
+    }
+    for(int i = 0; i < n; ++i) {
+        _velocities[i] += _accelerations[i] * (0.5 * dt);
+        _positions[i] += _velocities[i] * dt;
+    }
+    accelerations(_accelerations);
+    for(int i = 0; i < n; ++i) {
+        _velocities[i] += _accelerations[i] * (0.5 * dt);
+    }
+}
+
+void NBody::accelerations(std::vector<vec3>& out) const {
+    out.assign(size(), vec3{0});
+    if(usesTree()) {
+        tree(out);
+    } else {
+        direct(out);
+    }
+}
+
+void NBody::direct(std::vector<vec3>& out) const {
+    const int n = size();
+    for(int i = 0; i < n; ++i) {
+        vec3 a{0};
+        for(int j : _massive) {
+            if(j == i) { continue; }
+            auto ray = _positions[j] - _positions[i];
+            double r2 = dot(ray, ray);
+            a += ray * (_mu[j] / (r2 * std::sqrt(r2)));
+        }
+        out[i] = a;
+    }
+}
+
+void NBody::tree(std::vector<vec3>& out) const {
+    build();
+    
+    const int n = size();
+    const double theta2 = _theta * _theta;
+    int stack[8 * maxDepth];
+    
+    for(int i = 0; i < n; ++i) {
+        const vec3& p = _positions[i];
+        vec3 a{0};
+        int top = 0;
+        stack[top++] = 0;
+        while(top > 0) {
+            const Node& node = _nodes[stack[--top]];
+            if(node.mu == 0) { continue; }
+            
+            if(node.children < 0) {
+                for(int j = node.body; j >= 0; j = _next[j]) {
+                    if(j == i) { continue; }
+                    auto ray = _positions[j] - p;
+                    double r2 = dot(ray, ray);
+                    a += ray * (_mu[j] / (r2 * std::sqrt(r2)));
+                }
+                continue;
+            }
+            
+            auto ray = node.com - p;
+            double r2 = dot(ray, ray);
+            double size = 2.0 * node.half;
+            if(size * size < theta2 * r2) {
+                a += ray * (node.mu / (r2 * std::sqrt(r2)));
+                continue;
+            }
+            for(int c = 0; c < 8; ++c) {
+                stack[top++] = node.children + c;
+            }
+        }
+        out[i] = a;
+    }
+}
+
+void NBody::build() const {
+    _nodes.clear();
+    _next.assign(size(), -1);
+    if(_massive.empty()) { return; }
+    
+    vec3 lo = _positions[_massive[0]];
+    vec3 hi = lo;
+    for(int j : _massive) {
+        for(int k = 0; k < 3; ++k) {
+            lo.data[k] = min(lo.data[k], _positions[j].data[k]);
+            hi.data[k] = max(hi.data[k], _positions[j].data[k]);
+        }
+    }
+    auto extent = hi - lo;
+    double half = 0.5 * max(max(extent.x, extent.y), max(extent.z, 1.0));
+    _nodes.push_back(Node{(lo + hi) * 0.5, half * 1.0001, vec3{0}, 0, -1, -1, 0});
+    
+    for(int j : _massive) {
+        insert(j);
+    }
+    
+    // Children are always created after their parent, so a reverse sweep visits
+    // every cell after all of its descendants.
+    for(int i = int(_nodes.size()) - 1; i >= 0; --i) {
+        Node& node = _nodes[i];
+        vec3 moment{0};
+        double mu = 0;
+        if(node.children < 0) {
+            for(int j = node.body; j >= 0; j = _next[j]) {
+                moment += _positions[j] * _mu[j];
+                mu += _mu[j];
+            }
+        } else {
+            for(int c = 0; c < 8; ++c) {
+                const Node& child = _nodes[node.children + c];
+                moment += child.com * child.mu;
+                mu += child.mu;
+            }
+        }
+        node.mu = mu;
+        node.com = mu > 0 ? moment / mu : node.centre;
+    }
+}
+
+void NBody::insert(int body) const {
+    const vec3& p = _positions[body];
+    int index = 0;
+    
+    for(int depth = 0; ; ++depth) {
+        if(_nodes[index].children >= 0) {
+            const Node& node = _nodes[index];
+            int octant = (p.x > node.centre.x) | ((p.y > node.centre.y) << 1) | ((p.z > node.centre.z) << 2);
+            index = node.children + octant;
+            continue;
+        }
+        
+        // Leaf with room left, or too deep to keep splitting: chain the body in.
+        if(_nodes[index].count < leafSize || depth >= maxDepth) {
+            _next[body] = _nodes[index].body;
+            _nodes[index].body = body;
+            _nodes[index].count += 1;
+            return;
+        }
+        
+        // Full leaf: split it and push its bodies one level down.
+        int first = int(_nodes.size());
+        Node parent = _nodes[index];
+        double half = parent.half * 0.5;
+        for(int c = 0; c < 8; ++c) {
+            vec3 offset{(c & 1) ? half : -half, (c & 2) ? half : -half, (c & 4) ? half : -half};
+            _nodes.push_back(Node{parent.centre + offset, half, vec3{0}, 0, -1, -1, 0});
+        }
+        _nodes[index].children = first;
+        _nodes[index].body = -1;
+        _nodes[index].count = 0;
+        for(int j = parent.body; j >= 0; ) {
+            int next = _next[j];
+            const vec3& q = _positions[j];
+            int octant = (q.x > parent.centre.x) | ((q.y > parent.centre.y) << 1) | ((q.z > parent.centre.z) << 2);
+            Node& child = _nodes[first + octant];
+            _next[j] = child.body;
+            child.body = j;
+            child.count += 1;
+            j = next;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//
+//  NBody.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <vector>
+#include "physics.hpp"
+
+class PlanetarySystem;
+
+/// Full N-body propagation, where every massive body attracts every other one.
+/// Test particles (spacecraft, with a zero gravitational parameter) feel the
+/// bodies but do not pull on them. Small systems are summed directly; above a
+/// threshold the massive bodies are sorted into a Barnes-Hut octree, bringing the
+/// cost of an evaluation down from O(n²) to O(n log n).
+///
+/// States are advanced with a kick-drift-kick leapfrog, which only needs one force
+/// evaluation per step and keeps the energy of long runs bounded.
+class NBody final {
+public:
+    
+    NBody() {}
+    
+    /// Seeds an N-body run with the bodies of a planetary system at a given epoch.
+    static NBody fromSystem(const PlanetarySystem& system, double epoch);
+    
+    /// Adds a body and returns its index. Use a zero `mu` for test particles.
+    int add(const State& state, double mu);
+    
+    /// Advances every body by `dt`.
+    void step(double dt);
+    
+    /// Accelerations of every body, in the same order they were added.
+    void accelerations(std::vector<vec3>& out) const;
+    
+    State stateVectors(int index) const { return State(_positions[index], _velocities[index]); }
+    
+    int size() const { return int(_positions.size()); }
+    
+    /// Whether evaluations currently go through the octree.
+    bool usesTree() const { return int(_massive.size()) > _treeThreshold; }
+    
+    /// Number of massive bodies above which the octree is used.
+    void setTreeThreshold(int bodies) { _treeThreshold = bodies; }
+    
+    /// Barnes-Hut opening angle: a cell is treated as a point mass when its size
+    /// over its distance is below `theta`. Zero makes the tree exact.
+    void setOpeningAngle(double theta) { _theta = theta; }
+    
+private:
+    
+    struct Node {
+        vec3    centre;
+        double  half;
+        vec3    com;
+        double  mu;
+        /// Index of the first of eight children, or -1 for leaves.
+        int     children;
+        /// First body of a leaf (chained through `_next`), or -1.
+        int     body;
+        /// Number of bodies chained in a leaf.
+        int     count;
+    };
+    
+    void direct(std::vector<vec3>& out) const;
+    void tree(std::vector<vec3>& out) const;
+    void build() const;
+    void insert(int body) const;
+    
+    std::vector<vec3>   _positions;
+    std::vector<vec3>   _velocities;
+    std::vector<double> _mu;
+    std::vector<int>    _massive;
+    
+    std::vector<vec3>   _accelerations;
+    bool                _accelerationsValid = false;
+    
+    int                 _treeThreshold = 256;
+    double              _theta = 0.5;
+    
+    mutable std::vector<Node>   _nodes;
+    mutable std::vector<int>    _next;
+};
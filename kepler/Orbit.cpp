@@ -8,8 +8,11 @@
 
 #include "Orbit.hpp"
 #include "MassiveBody.hpp"
+#include <stdexcept>
 
-Orbit::Orbit(const MassiveBody& planet, const vec3& pos, const vec3& v) {
+Orbit::Orbit(const MassiveBody& planet, const vec3& pos, const vec3& v) :
+    _gravitationalParameter(planet.gravitationalParameter())
+{
     // Elements calculation from
     // https://downloads.rene-schwarz.com/download/M002-Cartesian_State_Vectors_to_Keplerian_Orbit_Elements.pdf
     vec3 r = pos - planet.position();
@@ -45,6 +48,7 @@ Orbit::Orbit(const MassiveBody& planet,
              double arg_p,
              double raan,
              double v) :
+    _gravitationalParameter(planet.gravitationalParameter()),
     _sma(a),
     _eccentricity(e),
     _inclination(i),
@@ -55,3 +59,45 @@ Orbit::Orbit(const MassiveBody& planet,
     _periapsis = _sma * (1 - e);
     _apoapsis = _sma * (1 + e);
 }
+
+double Orbit::period() const {
+    return 2.0 * M_PI * std::sqrt(std::pow(_sma, 3) / _gravitationalParameter);
+}
+
+State Orbit::stateVectors(double dt) const {
+    if(_eccentricity >= 1) { throw std::runtime_error("Only closed orbits can be propagated"); }
+    double e = _eccentricity;
+    double a = _sma;
+    
+    // True anomaly at epoch -> mean anomaly at epoch + dt -> eccentric anomaly.
+    double nu = radians(_anomaly);
+    double E = 2.0 * std::atan(std::sqrt((1 - e)/(1 + e)) * std::tan(nu/2.0));
+    double M = E - e * std::sin(E) + std::sqrt(_gravitationalParameter / (a*a*a)) * dt;
+    M = std::fmod(M, 2.0 * M_PI);
+    E = (e < 0.8) ? M : M_PI;
+    for(int i = 0; i < 32; ++i) {
+        double step = (E - e * std::sin(E) - M) / (1 - e * std::cos(E));
+        E -= step;
+        if(std::abs(step) < 1e-14) { break; }
+    }
+    
+    double cosE = std::cos(E);
+    double sinE = std::sin(E);
+    double b = std::sqrt(1 - e*e);
+    double r = a * (1 - e * cosE);
+    double rate = std::sqrt(_gravitationalParameter * a) / r;
+    
+    // Perifocal frame, then rotated by the argument of periapsis, inclination and RAAN.
+    double P = a * (cosE - e);
+    double Q = a * b * sinE;
+    double vP = -rate * sinE;
+    double vQ = rate * b * cosE;
+    
+    double cO = std::cos(radians(_raan)), sO = std::sin(radians(_raan));
+    double cw = std::cos(radians(_argOfPeriapsis)), sw = std::sin(radians(_argOfPeriapsis));
+    double ci = std::cos(radians(_inclination)), si = std::sin(radians(_inclination));
+    
+    vec3 p{cO*cw - sO*sw*ci, sO*cw + cO*sw*ci, sw*si};
+    vec3 q{-cO*sw - sO*cw*ci, -sO*sw + cO*cw*ci, cw*si};
+    return State(p*P + q*Q, p*vP + q*vQ);
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 #include "vec.hpp"
+#include "physics.hpp"
 
 class MassiveBody;
 
@@ -41,8 +42,16 @@ struct Orbit final {
     
     double trueAnomaly() const { return _anomaly; }
     
+    /// Period of the orbit, in seconds.
+    double period() const;
+    
+    /// Position and velocity relative to the planet, `dt` seconds after the
+    /// epoch the orbit was defined at. Only closed orbits can be propagated.
+    State stateVectors(double dt = 0) const;
+    
 private:
     
+    double _gravitationalParameter;
     double _sma;
     double _periapsis;
     double _apoapsis;
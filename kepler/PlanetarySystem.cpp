@@ -0,0 +1,92 @@
+//
+//  PlanetarySystem.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "PlanetarySystem.hpp"
+#include "Integrator.hpp"
+#include <stdexcept>
+
+int PlanetarySystem::addRoot(std::shared_ptr<const MassiveBody> body) {
+    if(!_bodies.empty()) { throw std::runtime_error("A planetary system only has one root"); }
+    _bodies.push_back(Entry{body, nullptr, -1, INFINITY, 0, INFINITY, {}});
+    return 0;
+}
+
+int PlanetarySystem::add(std::shared_ptr<const MassiveBody> body, int parent, const Orbit& orbit) {
+    if(parent < 0 || parent >= size()) { throw std::runtime_error("Unknown parent body"); }
+    
+    // Laplace's sphere of influence.
+    double ratio = body->gravitationalParameter() / _bodies[parent].body->gravitationalParameter();
+    double soi = orbit.semiMajorAxis() * std::pow(ratio, 0.4);
+    
+    int index = size();
+    _bodies.push_back(Entry{
+        body,
+        std::make_shared<const Orbit>(orbit),
+        parent,
+        soi,
+        orbit.periapsis() - soi,
+        orbit.apoapsis() + soi,
+        {}
+    });
+    _bodies[parent].children.push_back(index);
+    return index;
+}
+
+State PlanetarySystem::relativeState(int index, double epoch) const {
+    const auto& entry = _bodies[index];
+    if(!entry.orbit) { return State(); }
+    return entry.orbit->stateVectors(epoch);
+}
+
+State PlanetarySystem::stateVectors(int index, double epoch) const {
+    State state;
+    for(int i = index; i > 0; i = _bodies[i].parent) {
+        auto relative = relativeState(i, epoch);
+        state.p += relative.p;
+        state.v += relative.v;
+    }
+    return state;
+}
+
+int PlanetarySystem::dominantBody(const vec3& position, double epoch) const {
+    State state(position, vec3{0});
+    return handoff(0, state, epoch);
+}
+
+int PlanetarySystem::handoff(int central, State& state, double epoch) const {
+    const auto& entry = _bodies[central];
+    
+    // Leaving the sphere of influence hands over to the parent.
+    if(entry.parent >= 0 && dot(state.p, state.p) > entry.soi * entry.soi) {
+        auto frame = relativeState(central, epoch);
+        state = State(state.p + frame.p, state.v + frame.v);
+        return handoff(entry.parent, state, epoch);
+    }
+    
+    // Children are only located (which means solving Kepler's equation) when the
+    // spacecraft is within the band of distances their sphere can sweep through.
+    double r = state.p.magnitude();
+    for(int child : entry.children) {
+        const auto& c = _bodies[child];
+        if(r < c.innerBound || r > c.outerBound) { continue; }
+        auto frame = relativeState(child, epoch);
+        auto p = state.p - frame.p;
+        if(dot(p, p) < c.soi * c.soi) {
+            state = State(p, state.v - frame.v);
+            return handoff(child, state, epoch);
+        }
+    }
+    return central;
+}
+
+State PlanetarySystem::advance(Integrator& integrator, const SolidBody& body, int& central,
+                               double epoch, double dt) const {
+    auto state = integrator.advanceState(body, *_bodies[central].body, epoch, dt);
+    central = handoff(central, state, epoch + dt);
+    return state;
+}
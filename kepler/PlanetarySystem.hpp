@@ -0,0 +1,77 @@
+//
+//  PlanetarySystem.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <memory>
+#include <vector>
+#include "MassiveBody.hpp"
+#include "Orbit.hpp"
+
+class Integrator;
+class SolidBody;
+
+/// A hierarchy of massive bodies (star, planets, moons) moving on fixed Keplerian
+/// orbits around their parent, for patched-conic propagation. Each body keeps its
+/// own frame, centred on itself: a spacecraft is integrated relative to the body
+/// whose sphere of influence it is in, with that MassiveBody as the only planet,
+/// and `advance` steps it and re-expresses its state when it crosses into another
+/// sphere.
+class PlanetarySystem final {
+public:
+    
+    /// Adds the system's root body, which stays at the origin of the system frame.
+    int addRoot(std::shared_ptr<const MassiveBody> body);
+    
+    /// Adds a body orbiting `parent`. Orbital elements are given at epoch 0.
+    int add(std::shared_ptr<const MassiveBody> body, int parent, const Orbit& orbit);
+    
+    int size() const { return int(_bodies.size()); }
+    
+    const MassiveBody& body(int index) const { return *_bodies[index].body; }
+    
+    /// Index of the body's parent, or -1 for the root.
+    int parent(int index) const { return _bodies[index].parent; }
+    
+    /// Radius of the body's sphere of influence (infinite for the root).
+    double sphereOfInfluence(int index) const { return _bodies[index].soi; }
+    
+    /// Position and velocity of a body relative to its parent.
+    State relativeState(int index, double epoch) const;
+    
+    /// Position and velocity of a body in the system (root) frame.
+    State stateVectors(int index, double epoch) const;
+    
+    /// Deepest body whose sphere of influence contains a system-frame position.
+    int dominantBody(const vec3& position, double epoch) const;
+    
+    /// Checks a state, given relative to `central`, against the sphere of influence
+    /// boundaries. If it has crossed one, the state is re-expressed relative to the
+    /// new central body. Returns the index of the central body after the check.
+    int handoff(int central, State& state, double epoch) const;
+    
+    /// Integrates a body whose state is given relative to `central` from `epoch` to
+    /// `epoch + dt` with that body as the planet, then hands it off if the step
+    /// crossed a sphere of influence. `central` is updated to the body the returned
+    /// state is relative to.
+    State advance(Integrator& integrator, const SolidBody& body, int& central, double epoch, double dt) const;
+    
+private:
+    
+    struct Entry {
+        std::shared_ptr<const MassiveBody>  body;
+        std::shared_ptr<const Orbit>        orbit;
+        int                                 parent;
+        double                              soi;
+        /// Distances from the parent between which the sphere can be reached.
+        double                              innerBound;
+        double                              outerBound;
+        std::vector<int>                    children;
+    };
+    
+    std::vector<Entry>  _bodies;
+};
@@ -8,31 +8,69 @@
 
 #include "RK4.hpp"
 
-State RK4::advanceState(const SolidBody &body, const MassiveBody &planet, double dt) {
-    
-    auto previousState = body.stateVectors();
-    
-    auto a = evaluate(body, planet, dt, Derivative{});
-    auto b = evaluate(body, planet, dt*0.5, a);
-    auto c = evaluate(body, planet, dt*0.5, b);
-    auto d = evaluate(body, planet, dt, c);
-    
-    auto dpdt = (a.dp + 2.f*(b.dp + c.dp) + d.dp)/6.f;
-    auto dvdt = (a.dv + 2.f*(b.dv + c.dv) + d.dv)/6.f;
-    
-    return State(previousState.p + (dpdt * dt), previousState.v + (dvdt * dt));
+RK4::RK4() : _forces(std::make_shared<StandardForces>()) {}
+
+State RK4::advanceState(const SolidBody &body, const MassiveBody &planet, double epoch, double dt) {
+    return integrate(*_forces, BodyProperties(body), planet, epoch, dt, body.stateVectors());
+}
+
+/// A state and its transition matrix, integrated in the same stages.
+struct VariationalState {
+    State   motion;
+    mat66   transition;
+};
+
+struct VariationalDerivative {
+    Derivative  motion;
+    mat66       transition;
+};
+
+static VariationalState eulerStep(const VariationalState& x, const VariationalDerivative& d, double h) {
+    return VariationalState{eulerStep(x.motion, d.motion, h), eulerStep(x.transition, d.transition, h)};
+}
+
+static VariationalState rk4Update(const VariationalState& x, const VariationalDerivative& a,
+                                  const VariationalDerivative& b, const VariationalDerivative& c,
+                                  const VariationalDerivative& d, double dt) {
+    return VariationalState{rk4Update(x.motion, a.motion, b.motion, c.motion, d.motion, dt),
+                            rk4Update(x.transition, a.transition, b.transition, c.transition, d.transition, dt)};
+}
+
+/// Derivative of the transition matrix: d(phi)/dt = [0 I; dA/dr dA/dv] phi.
+static mat66 variational(const mat33& dadr, const mat33& dadv, const mat66& phi) {
+    mat66 d;
+    for(int i = 0; i < 3; ++i) {
+        for(int j = 0; j < 6; ++j) {
+            d[i][j] = phi[i+3][j];
+            double sum = 0;
+            for(int k = 0; k < 3; ++k) {
+                sum += dadr[i][k] * phi[k][j] + dadv[i][k] * phi[k+3][j];
+            }
+            d[i+3][j] = sum;
+        }
+    }
+    return d;
 }
 
-Derivative RK4::evaluate(const SolidBody &body, const MassiveBody &planet, double dt,const Derivative &d) {
-    auto previousState = body.stateVectors();
-    auto s = State(previousState.p + (d.dp * dt), previousState.v + (d.dv * dt));
-    return Derivative(s.v, acceleration(body, s, planet));
+State RK4::advanceState(const SolidBody &body, const MassiveBody &planet, double epoch, double dt,
+                        mat66 &transition) {
+    prepare(*_forces, planet, epoch, dt);
+    BodyProperties properties(body);
+    double ballistic = properties.dragCoefficient * properties.surfaceArea / properties.mass;
+    auto next = rk4Step(VariationalState{body.stateVectors(), transition}, dt,
+                        [&](const VariationalState& s, double offset, int stage) {
+        StageContext context(properties, planet, s.motion, epoch + offset, stage);
+        auto dadr = planet.gravityGradient(context.local);
+        auto drag = planet.dragPartials(context.local, s.motion.v, ballistic);
+        return VariationalDerivative{Derivative(s.motion.v, _forces->acceleration(context)),
+                                     variational(dadr + drag.position, drag.velocity, s.transition)};
+    });
+    transition = next.transition;
+    return next.motion;
 }
 
-vec3 RK4::acceleration(const SolidBody &body, const State& state, const MassiveBody &planet) {
-    auto airspeed = state.v - planet.inertialVelocity(state.p);
-    auto drag = 0.5 * planet.atmosphericDensity(state.p)
-              * std::pow(airspeed.magnitude(), 2)
-              *body.surfaceArea() * body.dragCoefficient();
-    return ((body.forces() - airspeed.normalize(drag)) / body.mass()) + planet.gravity(state.p);
+MassState RK4::advanceState(const SolidBody &body, const MassiveBody &planet, double epoch, double dt,
+                            const MassState &state, double massRate) {
+    auto rate = vec<double, 1>(massRate);
+    return advance(body, planet, epoch, dt, state, [&](const StageContext&, const MassState&) { return rate; });
 }
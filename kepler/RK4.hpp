@@ -7,19 +7,76 @@
 //
 
 #pragma once
+#include <memory>
 #include "Integrator.hpp"
+#include "ForceModels.hpp"
+#include "RungeKutta.hpp"
 
 class RK4 final : public Integrator {
 public:
     
-    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double dt);
+    /// Creates an integrator using every standard force model.
+    RK4();
     
-private:
+    /// Creates an integrator with a custom force pipeline.
+    RK4(std::shared_ptr<ForceModel> forces) : _forces(forces) {}
+    
+    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt);
+    
+    virtual MassState advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                                   const MassState& state, double massRate);
+    
+    /// The transition matrix follows the variational equations, with the gravity
+    /// gradient of the central term and the drag partials; the other forces are
+    /// taken as independent of the state. Both are advanced in the same stages.
+    virtual State advanceState(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                               mat66& transition);
     
-    Derivative evaluate(const SolidBody& body, const MassiveBody& planet, double dt, const Derivative& d);
+    /// Integrates an augmented state from `epoch` to `epoch + dt`. `rates` gives the
+    /// derivative of the extra variables, called as
+    /// `rates(const StageContext&, const AugmentedState<N>&) -> vec<double, N>`.
+    template <int N, typename Rates>
+    AugmentedState<N> advance(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                              const AugmentedState<N>& state, const Rates& rates);
+    
+    /// Integrates a state of any scalar type from `epoch` to `epoch + dt`, through the
+    /// force pipeline `forces`: the step every `advanceState` takes. `Model` is a
+    /// `ForceModel` for doubles, and a `Forces` pipeline for the other scalar types.
+    /// Seeding dual numbers on the initial state or on the body's properties gives
+    /// the exact derivatives of the final state with respect to them in a single
+    /// pass, where finite differences need a pair of runs per variable.
+    template <typename Model, typename T>
+    static BasicState<T> integrate(Model& forces, const BasicBodyProperties<T>& body, const MassiveBody& planet,
+                                   double epoch, double dt, const BasicState<T>& state);
+    
+private:
     
-    vec3 acceleration(const SolidBody& body, const State& state, const MassiveBody& planet);
+    /// Prepares the force models for the three epochs of a step.
+    static void prepare(ForceModel& forces, const MassiveBody& planet, double epoch, double dt) {
+        // The two middle stages share an epoch, so there are only three to prepare for.
+        double epochs[] = {epoch, epoch + dt*0.5, epoch + dt};
+        forces.prepare(planet, epochs, 3);
+    }
     
+    std::shared_ptr<ForceModel> _forces;
 };
 
+template <int N, typename Rates>
+AugmentedState<N> RK4::advance(const SolidBody& body, const MassiveBody& planet, double epoch, double dt,
+                               const AugmentedState<N>& state, const Rates& rates) {
+    prepare(*_forces, planet, epoch, dt);
+    BodyProperties properties(body);
+    return rk4Step(state, dt, [&](const AugmentedState<N>& s, double offset, int stage) {
+        StageContext context(properties, planet, s.motion(), epoch + offset, stage, s.mass());
+        return AugmentedDerivative<N>(s.v, _forces->acceleration(context), rates(context, s));
+    });
+}
 
+template <typename Model, typename T>
+BasicState<T> RK4::integrate(Model& forces, const BasicBodyProperties<T>& body, const MassiveBody& planet,
+                             double epoch, double dt, const BasicState<T>& state) {
+    prepare(forces, planet, epoch, dt);
+    return rk4Step(state, dt, [&](const BasicState<T>& s, double offset, int stage) {
+        return BasicDerivative<T>(s.v, forces.acceleration(BasicStageContext<T>(body, planet, s, epoch + offset, stage)));
+    });
+}
@@ -0,0 +1,58 @@
+//
+//  RigidBody.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "RigidBody.hpp"
+#include <stdexcept>
+
+RigidBody::RigidBody(const mat33& gyration,
+                     const AttitudeControl& control,
+                     double maxStepAngle,
+                     int maxSubsteps) :
+_gyration(gyration),
+_control(control),
+_maxStepAngle(maxStepAngle),
+_maxSubsteps(maxSubsteps)
+{
+    if(!(maxStepAngle > 0) || maxSubsteps < 1) {
+        throw std::runtime_error("Invalid rigid body sub-stepping limits");
+    }
+    // Throws if the tensor is not positive definite, as any physical one is.
+    _inverseGyration = Cholesky<3>(gyration).inverse();
+}
+
+vec3 RigidBody::controlTorque(const Attitude& attitude, double mass, const vec3& direction,
+                              const vec3& turnRate) const {
+    // Pointing error, as a rotation vector along axis × direction. Its length is the
+    // sine of the error angle up to 90°, then 2 - sine up to 180°: the same as the
+    // angle to first order, increasing with it, and without the trigonometry. Pointing
+    // exactly backwards, any axis perpendicular to the thrust axis will do: as in
+    // quat::between, it is crossed with a basis vector it is far from parallel to.
+    auto toBody = attitude.orientation.conjugate();
+    auto axis = attitude.orientation.rotate(thrustAxis());
+    auto normal = vec3::cross(axis, direction);
+    vec3 theta = normal;
+    if(dot(axis, direction) < 0) {
+        double s = normal.magnitude();
+        if(s > 0) {
+            theta = normal * ((2 - s) / s);
+        } else {
+            const vec3 other = std::abs(axis.x) < 0.9 ? vec3{1, 0, 0} : vec3{0, 1, 0};
+            theta = vec3::cross(axis, other).normalize() * 2.0;
+        }
+    }
+    theta = toBody.rotate(theta);
+
+    double wn = _control.naturalFrequency;
+    auto w = attitude.rate;
+    auto alpha = theta * (wn * wn) + (toBody.rotate(turnRate) - w) * (2 * _control.damping * wn);
+    double magnitude = alpha.magnitude();
+    if(magnitude > _control.maxAcceleration) {
+        alpha = alpha * (_control.maxAcceleration / magnitude);
+    }
+    return (_gyration * alpha + vec3::cross(w, _gyration * w)) * mass;
+}
@@ -0,0 +1,159 @@
+//
+//  RigidBody.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include "quaternion.hpp"
+#include "RungeKutta.hpp"
+#include "utils.hpp"
+
+/// Orientation and angular velocity of a rigid body.
+struct Attitude {
+
+    Attitude() : orientation(), rate(0.0) {}
+    Attitude(const quat& orientation, const vec3& rate) : orientation(orientation), rate(rate) {}
+
+    /// Rotation from the body frame to the inertial frame.
+    quat    orientation;
+    /// Angular velocity, in the body frame (rad/s).
+    vec3    rate;
+};
+
+/// Time derivative of an attitude.
+struct AttitudeDerivative {
+    quat    dq;
+    vec3    dw;
+};
+
+inline Attitude
+eulerStep(const Attitude& x, const AttitudeDerivative& d, double h) {
+    return Attitude(eulerStep(x.orientation, d.dq, h), eulerStep(x.rate, d.dw, h));
+}
+
+inline Attitude
+rk4Update(const Attitude& x, const AttitudeDerivative& a, const AttitudeDerivative& b,
+          const AttitudeDerivative& c, const AttitudeDerivative& d, double dt) {
+    return Attitude(rk4Update(x.orientation, a.dq, b.dq, c.dq, d.dq, dt),
+                    rk4Update(x.rate, a.dw, b.dw, c.dw, d.dw, dt));
+}
+
+/// Gains of the idealised attitude controller that steers a vehicle's thrust axis
+/// towards its guidance target: a PD law on the pointing error, acting on angular
+/// acceleration and saturated at `maxAcceleration`. Roll is only damped.
+struct AttitudeControl {
+    /// Natural frequency of the closed loop (rad/s).
+    double  naturalFrequency;
+    double  damping;
+    /// Largest angular acceleration the actuators can give (rad/s²).
+    double  maxAcceleration;
+};
+
+/// Rotational dynamics of a rigid body: the inertia tensor, Euler's equations and
+/// an attitude integrator that runs at its own rate.
+///
+/// Rotations are much faster than orbital motion, so attitude is not integrated in
+/// the translational stages: `advance` sub-steps Euler's equations inside a
+/// translational step, with as many RK4 sub-steps as the rotation needs (bounded
+/// by the angle turned per sub-step and by the torque law's bandwidth), and none at
+/// all when the body is neither turning nor torqued.
+class RigidBody {
+public:
+
+    /// `gyration` is the inertia tensor per unit mass, in the body frame (m²): the
+    /// tensor follows the mass as propellant burns. Sub-steps turn the body by at
+    /// most `maxStepAngle` radians.
+    RigidBody(const mat33& gyration,
+              const AttitudeControl& control,
+              double maxStepAngle = radians(1.0),
+              int maxSubsteps = 256);
+
+    /// Direction of thrust, in the body frame.
+    static vec3 thrustAxis() { return vec3{0, 0, 1}; }
+
+    /// Inertia tensor for a given mass, in the body frame (kg·m²).
+    mat33 inertia(double mass) const { return _gyration * mass; }
+
+    const AttitudeControl& control() const { return _control; }
+
+    /// Angular acceleration under a body-frame torque, gyroscopic term included:
+    /// `I⁻¹(τ - ω × Iω)`.
+    vec3 angularAcceleration(const Attitude& attitude, double mass, const vec3& torque) const {
+        auto w = attitude.rate;
+        return _inverseGyration * (torque / mass - vec3::cross(w, _gyration * w));
+    }
+
+    /// Body-frame torque the controller applies to turn the thrust axis towards the
+    /// unit vector `direction` (inertial frame), which turns at `turnRate` (inertial, rad/s). The
+    /// gyroscopic term is cancelled, so the closed loop behaves like a damped
+    /// oscillator on each axis; feeding the turn rate forward removes the lag it
+    /// would otherwise have behind a target that keeps turning.
+    vec3 controlTorque(const Attitude& attitude, double mass, const vec3& direction,
+                       const vec3& turnRate = vec3{0.0}) const;
+
+    /// Advances an attitude by `dt` seconds. `torque` gives the body-frame torque,
+    /// called as `torque(const Attitude&) -> vec3`; `bandwidth` is how fast it reacts
+    /// to the attitude (rad/s), 0 if it does not. The number of sub-steps used is
+    /// added to `substeps` when given.
+    template <typename Torque>
+    Attitude advance(const Attitude& attitude, double mass, double dt, const Torque& torque,
+                     double bandwidth = 0, int* substeps = nullptr) const;
+
+    /// Advances an attitude by `dt` seconds with the controller tracking `direction`.
+    Attitude track(const Attitude& attitude, double mass, double dt, const vec3& direction,
+                   const vec3& turnRate = vec3{0.0}, int* substeps = nullptr) const {
+        auto torque = [&](const Attitude& a) { return controlTorque(a, mass, direction, turnRate); };
+        double bandwidth = _control.naturalFrequency * std::max(1.0, 2 * _control.damping);
+        return advance(attitude, mass, dt, torque, bandwidth, substeps);
+    }
+
+private:
+
+    /// Largest `bandwidth·h` for a sub-step of length h, well inside the stability
+    /// region of RK4, so that stiff control laws stay accurate.
+    static constexpr double maxStiffness = 0.5;
+
+    AttitudeDerivative derivative(const Attitude& attitude, const vec3& acceleration) const {
+        // dq/dt = q·(0, ω)/2, with ω in the body frame.
+        return AttitudeDerivative{attitude.orientation * quat(0, attitude.rate.x, attitude.rate.y, attitude.rate.z) * 0.5,
+                                  acceleration};
+    }
+
+    mat33           _gyration;
+    mat33           _inverseGyration;
+    AttitudeControl _control;
+    double          _maxStepAngle;
+    int             _maxSubsteps;
+};
+
+template <typename Torque>
+Attitude RigidBody::advance(const Attitude& attitude, double mass, double dt, const Torque& torque,
+                            double bandwidth, int* substeps) const {
+    auto acceleration = [&](const Attitude& a) { return angularAcceleration(a, mass, torque(a)); };
+    auto alpha = acceleration(attitude);
+
+    // Nothing to integrate: the orientation holds as long as nothing turns it.
+    double rate = attitude.rate.magnitude();
+    if(rate == 0 && alpha.magnitude() == 0) { return attitude; }
+
+    double angle = rate * dt + 0.5 * alpha.magnitude() * dt * dt;
+    double needed = std::max(angle / _maxStepAngle, bandwidth * dt / maxStiffness);
+    int count = clamp(int(std::ceil(needed)), 1, _maxSubsteps);
+    if(substeps) { *substeps += count; }
+
+    double h = dt / count;
+    Attitude s = attitude;
+    for(int i = 0; i < count; ++i) {
+        s = rk4Step(s, h, [&](const Attitude& a, double, int stage) {
+            return derivative(a, i || stage ? acceleration(a) : alpha);
+        });
+        // Renormalised every sub-step, so the orientation never drifts off unit length.
+        s.orientation = s.orientation.normalize();
+    }
+    return s;
+}
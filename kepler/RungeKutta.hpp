@@ -0,0 +1,91 @@
+//
+//  RungeKutta.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include "physics.hpp"
+#include "expression.hpp"
+
+/// The classical fourth-order Runge-Kutta step, written once for everything kepler
+/// integrates with it: orbital states, augmented states, state transition matrices
+/// and attitudes.
+///
+/// `derivative(state, offset, stage)` gives the derivative of a stage state, `offset`
+/// seconds into the step. Stages are numbered by the epoch they sample (0 at the
+/// start, 1 half-way, 2 at the end), so that the two middle ones, which share an
+/// epoch, also share whatever was prepared for it. A state type and its derivative
+/// only need two overloads, found by argument-dependent lookup:
+///
+///     X eulerStep(const X& x, const D& d, double h);          // x + d·h
+///     X rk4Update(const X& x, const D& a, const D& b,
+///                 const D& c, const D& d, double dt);         // x + (a + 2(b + c) + d)·dt/6
+///
+/// which apply the component versions below to each of their members.
+template <typename X, typename Derivative>
+X rk4Step(const X& x, double dt, const Derivative& derivative) {
+    auto a = derivative(x, 0.0, 0);
+    auto b = derivative(eulerStep(x, a, dt*0.5), dt*0.5, 1);
+    auto c = derivative(eulerStep(x, b, dt*0.5), dt*0.5, 1);
+    auto d = derivative(eulerStep(x, c, dt), dt, 2);
+    return rk4Update(x, a, b, c, d, dt);
+}
+
+// MARK: -
+// MARK: Components
+
+/// `x + d·h`, for a vector, matrix or quaternion.
+template <typename R>
+R eulerStep(const R& x, const R& d, double h) {
+    return x + d * h;
+}
+
+template <int r, int c>
+matrix<r, c> eulerStep(const matrix<r, c>& x, const matrix<r, c>& d, double h) {
+    return lazy(x) + lazy(d) * h;
+}
+
+/// The RK4 update `x + (a + 2(b + c) + d) * dt/6`. Matrices fuse it into a single
+/// pass over their components.
+template <typename R>
+R rk4Update(const R& x, const R& a, const R& b, const R& c, const R& d, double dt) {
+    return x + (a + 2.0*(b + c) + d) / 6.0 * dt;
+}
+
+template <int r, int k>
+matrix<r, k> rk4Update(const matrix<r, k>& x, const matrix<r, k>& a, const matrix<r, k>& b,
+                       const matrix<r, k>& c, const matrix<r, k>& d, double dt) {
+    return lazy(x) + (lazy(a) + 2.0*(lazy(b) + c) + d) / 6.0 * dt;
+}
+
+// MARK: -
+// MARK: States
+
+template <typename T>
+BasicState<T> eulerStep(const BasicState<T>& x, const BasicDerivative<T>& d, double h) {
+    return BasicState<T>(eulerStep(x.p, d.dp, h), eulerStep(x.v, d.dv, h));
+}
+
+template <typename T>
+BasicState<T> rk4Update(const BasicState<T>& x, const BasicDerivative<T>& a, const BasicDerivative<T>& b,
+                        const BasicDerivative<T>& c, const BasicDerivative<T>& d, double dt) {
+    return BasicState<T>(rk4Update(x.p, a.dp, b.dp, c.dp, d.dp, dt),
+                         rk4Update(x.v, a.dv, b.dv, c.dv, d.dv, dt));
+}
+
+template <int N>
+AugmentedState<N> eulerStep(const AugmentedState<N>& x, const AugmentedDerivative<N>& d, double h) {
+    return AugmentedState<N>(eulerStep(x.p, d.dp, h), eulerStep(x.v, d.dv, h), eulerStep(x.q, d.dq, h));
+}
+
+template <int N>
+AugmentedState<N> rk4Update(const AugmentedState<N>& x, const AugmentedDerivative<N>& a,
+                            const AugmentedDerivative<N>& b, const AugmentedDerivative<N>& c,
+                            const AugmentedDerivative<N>& d, double dt) {
+    return AugmentedState<N>(rk4Update(x.p, a.dp, b.dp, c.dp, d.dp, dt),
+                             rk4Update(x.v, a.dv, b.dv, c.dv, d.dv, dt),
+                             rk4Update(x.q, a.dq, b.dq, c.dq, d.dq, dt));
+}
@@ -0,0 +1,47 @@
+//
+//  SolarRadiation.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "SolarRadiation.hpp"
+
+constexpr double SolarRadiation::pressureAt1AU;
+constexpr double SolarRadiation::astronomicalUnit;
+
+SolarRadiation::Geometry SolarRadiation::sample(double epoch, double occultingRadius) const {
+    auto sun = _sun->sample(epoch).position;
+    double distance = sun.magnitude();
+    double ratio = astronomicalUnit / distance;
+    return Geometry{
+        sun,
+        sun / distance,
+        distance,
+        pressureAt1AU * ratio * ratio,
+        (_sunRadius + occultingRadius) / distance
+    };
+}
+
+double SolarRadiation::eclipse(const Geometry& geometry, const vec3& at, double occultingRadius) const {
+    // Apparent radii of the Sun and the occulting body, and their separation, as
+    // seen from the spacecraft (Montenbruck & Gill, 3.4.2).
+    auto toSun = geometry.sun - at;
+    double sunDistance = toSun.magnitude();
+    double r = at.magnitude();
+    double a = std::asin(clamp(_sunRadius / sunDistance, -1.0, 1.0));
+    double b = std::asin(clamp(occultingRadius / r, -1.0, 1.0));
+    double c = std::acos(clamp(-dot(at, toSun) / (r * sunDistance), -1.0, 1.0));
+    
+    if(c >= a + b) { return 1; }
+    if(c <= b - a) { return 0; }
+    if(c <= a - b) { return 1 - (b*b)/(a*a); }
+    
+    double x = (c*c + a*a - b*b) / (2*c);
+    double y = std::sqrt(max(a*a - x*x, 0.0));
+    double hidden = a*a * std::acos(clamp(x/a, -1.0, 1.0))
+                  + b*b * std::acos(clamp((c - x)/b, -1.0, 1.0))
+                  - c*y;
+    return 1 - hidden / (M_PI * a*a);
+}
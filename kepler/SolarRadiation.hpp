@@ -0,0 +1,85 @@
+//
+//  SolarRadiation.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <memory>
+#include "dual.hpp"
+#include "ThirdBody.hpp"
+
+/// Solar radiation pressure around a MassiveBody, with a conical (umbra and
+/// penumbra) shadow model. Everything that only depends on the Sun's position is
+/// sampled once per epoch. Most evaluations are then in full sun, which is ruled
+/// in with a dot product and, on the night side, a comparison against the
+/// penumbra cone; the shadow geometry itself is only solved near the terminator.
+class SolarRadiation final {
+public:
+    
+    /// Radiation pressure at 1 AU, in N/m².
+    static constexpr double pressureAt1AU = 4.56e-6;
+    
+    static constexpr double astronomicalUnit = 149597870700.0;
+    
+    /// Sun geometry at one epoch, shared by every evaluation at that epoch.
+    struct Geometry {
+        /// Sun position, relative to the central body.
+        vec3    sun;
+        /// Unit vector from the central body to the Sun.
+        vec3    direction;
+        double  distance;
+        /// Radiation pressure at the central body's distance from the Sun.
+        double  pressure;
+        /// Tangent of the penumbra cone's half-angle.
+        double  penumbra;
+    };
+    
+    SolarRadiation(std::shared_ptr<const ThirdBody> sun, double sunRadius = 695700e3) :
+        _sun(sun),
+        _sunRadius(sunRadius) {}
+    
+    ~SolarRadiation() {}
+    
+    Geometry sample(double epoch, double occultingRadius) const;
+    
+    /// Visible fraction of the solar disc from `at` (relative to the central body,
+    /// of radius `occultingRadius`): 0 in the umbra, 1 in full sun.
+    double illumination(const Geometry& geometry, const vec3& at, double occultingRadius) const;
+    
+    /// Radiation pressure acceleration on a body with the given area-to-mass ratio
+    /// and reflectivity coefficient (1 for a black body, 2 for a perfect mirror).
+    /// Sun rays are taken as parallel, which is exact to within |at|/distance. Any
+    /// scalar type works; the illumination is only computed in doubles.
+    template <typename T>
+    vec<T, 3> acceleration(const Geometry& geometry, const vec<T, 3>& at, double occultingRadius,
+                           const T& areaToMass, const T& reflectivity) const {
+        T lit = constantOf(at, [&](const vec3& p) { return illumination(geometry, p, occultingRadius); });
+        if(lit == 0) { return vec<T, 3>(0); }
+        return vec<T, 3>(geometry.direction) * (-lit * geometry.pressure * reflectivity * areaToMass);
+    }
+    
+    const ThirdBody& sun() const { return *_sun; }
+    
+private:
+    
+    double eclipse(const Geometry& geometry, const vec3& at, double occultingRadius) const;
+    
+    std::shared_ptr<const ThirdBody>    _sun;
+    double                              _sunRadius;
+};
+
+inline double SolarRadiation::illumination(const Geometry& geometry, const vec3& at, double occultingRadius) const {
+    // Sunlit hemisphere: nothing can be in the way.
+    double along = dot(at, geometry.direction);
+    if(along >= 0) { return 1; }
+    
+    // Night side, but outside of the penumbra cone (which widens away from the Sun).
+    double outside = occultingRadius - along * geometry.penumbra;
+    double across2 = dot(at, at) - along * along;
+    if(across2 > outside * outside) { return 1; }
+    
+    return eclipse(geometry, at, occultingRadius);
+}
@@ -28,4 +28,37 @@ public:
     
     /// The body's frontal surface area, used to compute aerodyamic drag.
     virtual double surfaceArea() const = 0;
+    
+    /// The body's radiation pressure coefficient (1 absorbs all light, 2 reflects it all).
+    virtual double reflectivity() const = 0;
 };
+
+/// What the force models need to know about a body, read once per step rather than
+/// through a virtual call per stage, for any scalar type: seeding dual numbers on
+/// the drag coefficient, say, gives the derivatives of a trajectory with respect to it.
+template <typename T>
+struct BasicBodyProperties {
+    
+    BasicBodyProperties(const T& mass, const vec<T, 3>& forces, const T& dragCoefficient, const T& surfaceArea,
+                        const T& reflectivity) :
+        mass(mass),
+        forces(forces),
+        dragCoefficient(dragCoefficient),
+        surfaceArea(surfaceArea),
+        reflectivity(reflectivity) {}
+    
+    explicit BasicBodyProperties(const SolidBody& body) :
+        mass(body.mass()),
+        forces(body.forces()),
+        dragCoefficient(body.dragCoefficient()),
+        surfaceArea(body.surfaceArea()),
+        reflectivity(body.reflectivity()) {}
+    
+    T           mass;
+    vec<T, 3>   forces;
+    T           dragCoefficient;
+    T           surfaceArea;
+    T           reflectivity;
+};
+
+using BodyProperties = BasicBodyProperties<double>;
@@ -0,0 +1,194 @@
+//
+//  SphericalHarmonics.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "SphericalHarmonics.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+SphericalHarmonics::SphericalHarmonics(double mu, double radius, int degree) :
+_gravitationalParameter(mu),
+_radius(radius),
+_maxDegree(degree),
+_degree(degree)
+{
+    if(degree < 2) { throw std::runtime_error("Spherical harmonics need at least degree 2"); }
+    precompute();
+}
+
+SphericalHarmonics::SphericalHarmonics(double mu, double radius, const std::string& file, int degree) :
+SphericalHarmonics(mu, radius, degree)
+{
+    std::ifstream raw{file};
+    if(!raw.is_open()) { throw std::runtime_error("Unable to open gravity field " + file); }
+
+    std::string line;
+    while(std::getline(raw, line)) {
+        // Fortran-style exponents (1.0D-06) are common in published fields.
+        std::replace(line.begin(), line.end(), 'D', 'e');
+        std::replace(line.begin(), line.end(), 'd', 'e');
+        std::istringstream fields{line};
+        if(line.compare(0, 3, "gfc") == 0) { fields.ignore(3); }
+
+        int n, m;
+        double C, S;
+        if(!(fields >> n >> m >> C >> S)) { continue; }
+        if(n > _maxDegree || m > n || n < 2) { continue; }
+        setCoefficients(n, m, C, S);
+    }
+}
+
+void SphericalHarmonics::setCoefficients(int n, int m, double C, double S) {
+    if(n < 0 || n > _maxDegree || m < 0 || m > n) {
+        throw std::runtime_error("Spherical harmonic term out of range");
+    }
+    _C[index(n, m)] = C;
+    _S[index(n, m)] = (m == 0) ? 0 : S;
+}
+
+void SphericalHarmonics::setDegree(int degree) {
+    _degree = clamp(degree, 2, _maxDegree);
+}
+
+void SphericalHarmonics::precompute() {
+    const int N = _maxDegree;
+    const int D = _maxDegree + 1;
+
+    _offsets.resize(N + 1);
+    for(int m = 0, offset = 0; m <= N; ++m) {
+        _offsets[m] = offset;
+        offset += N + 1 - m;
+    }
+    const int terms = (N + 1) * (N + 2) / 2;
+    _C.assign(terms, 0);
+    _S.assign(terms, 0);
+    _fPlus.assign(terms, 0);
+    _fMinus.assign(terms, 0);
+    _fZ.assign(terms, 0);
+
+    for(int m = 0; m <= N; ++m) {
+        for(int n = m; n <= N; ++n) {
+            double k = (2.0*n + 1.0) / (2.0*n + 3.0);
+            int i = index(n, m);
+            if(m == 0) {
+                _fPlus[i] = std::sqrt(0.5 * k * (n + 1.0) * (n + 2.0));
+            } else {
+                _fPlus[i] = 0.5 * std::sqrt(k * (n + m + 1.0) * (n + m + 2.0));
+                _fMinus[i] = 0.5 * std::sqrt((m == 1 ? 2.0 : 1.0) * k * (n - m + 1.0) * (n - m + 2.0));
+            }
+            _fZ[i] = std::sqrt(k * (n + m + 1.0) * (n - m + 1.0));
+        }
+    }
+
+    _recursionOffsets.resize(D + 1);
+    for(int m = 0, offset = 0; m <= D; ++m) {
+        _recursionOffsets[m] = offset;
+        offset += D + 1 - m;
+    }
+    const int recursionTerms = (D + 1) * (D + 2) / 2;
+    _a.assign(recursionTerms, 0);
+    _b.assign(recursionTerms, 0);
+    _diagonal.assign(D + 1, 0);
+
+    for(int m = 0; m <= D; ++m) {
+        if(m > 0) {
+            _diagonal[m] = std::sqrt((2.0*m + 1.0) / (2.0*m)) * (m == 1 ? std::sqrt(2.0) : 1.0);
+        }
+        for(int n = m + 1; n <= D; ++n) {
+            int i = recursionIndex(n, m);
+            _a[i] = std::sqrt((2.0*n + 1.0) * (2.0*n - 1.0) / ((n - m) * double(n + m)));
+            _b[i] = std::sqrt((2.0*n + 1.0) * (n + m - 1.0) * (n - m - 1.0)
+                              / ((2.0*n - 3.0) * (n + m) * double(n - m)));
+        }
+    }
+}
+
+vec3 SphericalHarmonics::perturbation(const vec3& at) const {
+    const int N = _degree;
+    const int length = N + 2;
+
+    // Only three adjacent columns (orders m-1, m, m+1) of V/W are ever needed at
+    // once, so they are kept in a small rotating per-thread buffer.
+    static thread_local std::vector<double> scratch;
+    if(scratch.size() < std::size_t(6 * length)) { scratch.resize(6 * length); }
+    auto V = [&](int m) { return scratch.data() + (m % 3) * length; };
+    auto W = [&](int m) { return scratch.data() + (3 + m % 3) * length; };
+
+    const double r2 = at.x*at.x + at.y*at.y + at.z*at.z;
+    const double rho = _radius / r2;
+    const double x0 = at.x * rho;
+    const double y0 = at.y * rho;
+    const double z0 = at.z * rho;
+    const double rho2 = _radius * rho;
+
+    double vmm = _radius / std::sqrt(r2);
+    double wmm = 0;
+    double ax = 0, ay = 0, az = 0;
+
+    for(int m = 0; m <= N + 1; ++m) {
+        if(m > 0) {
+            double d = _diagonal[m];
+            double v = d * (x0*vmm - y0*wmm);
+            wmm = d * (x0*wmm + y0*vmm);
+            vmm = v;
+        }
+
+        double* v = V(m);
+        double* w = W(m);
+        const double* a = _a.data() + recursionIndex(m, m) - m;
+        const double* b = _b.data() + recursionIndex(m, m) - m;
+        v[m] = vmm;
+        w[m] = wmm;
+        if(m + 1 <= N + 1) {
+            v[m+1] = a[m+1] * z0 * v[m];
+            w[m+1] = a[m+1] * z0 * w[m];
+        }
+        for(int n = m + 2; n <= N + 1; ++n) {
+            v[n] = a[n] * z0 * v[n-1] - b[n] * rho2 * v[n-2];
+            w[n] = a[n] * z0 * w[n-1] - b[n] * rho2 * w[n-2];
+        }
+
+        if(m == 0) { continue; }
+
+        // Columns m-2, m-1 and m are now available: accumulate order k = m-1.
+        const int k = m - 1;
+        const double* vm = V(k);
+        const double* wm = W(k);
+        const double* vh = v;
+        const double* wh = w;
+        const int offset = index(k, k) - k;
+        const double* C = _C.data() + offset;
+        const double* S = _S.data() + offset;
+        const double* fPlus = _fPlus.data() + offset;
+        const double* fMinus = _fMinus.data() + offset;
+        const double* fZ = _fZ.data() + offset;
+
+        if(k == 0) {
+            for(int n = 2; n <= N; ++n) {
+                ax -= fPlus[n] * C[n] * vh[n+1];
+                ay -= fPlus[n] * C[n] * wh[n+1];
+                az -= fZ[n] * C[n] * vm[n+1];
+            }
+            continue;
+        }
+
+        const double* vl = V(k - 1);
+        const double* wl = W(k - 1);
+        for(int n = std::max(k, 2); n <= N; ++n) {
+            ax += fPlus[n] * (-C[n]*vh[n+1] - S[n]*wh[n+1])
+                + fMinus[n] * (C[n]*vl[n+1] + S[n]*wl[n+1]);
+            ay += fPlus[n] * (-C[n]*wh[n+1] + S[n]*vh[n+1])
+                + fMinus[n] * (-C[n]*wl[n+1] + S[n]*vl[n+1]);
+            az += fZ[n] * (-C[n]*vm[n+1] - S[n]*wm[n+1]);
+        }
+    }
+
+    const double scale = _gravitationalParameter / (_radius * _radius);
+    return vec3{ax * scale, ay * scale, az * scale};
+}
@@ -0,0 +1,75 @@
+//
+//  SphericalHarmonics.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <string>
+#include <vector>
+#include "GravityField.hpp"
+
+/// Degree/order N×N gravity field given by fully normalised Stokes coefficients
+/// (EGM/ICGEM convention). Accelerations are evaluated with the normalised
+/// Cunningham recursion on cartesian coordinates, which has no singularity at
+/// the poles. Every per-term constant is computed once and stored order-major,
+/// in the same sequence the evaluation loop walks through them.
+class SphericalHarmonics final : public GravityField {
+public:
+
+    /// Creates a field of up to `degree`×`degree`, with every coefficient set to zero.
+    SphericalHarmonics(double mu, double radius, int degree);
+
+    /// Loads normalised coefficients from a `n m C S` table (ICGEM `gfc` lines are
+    /// accepted), ignoring terms above `degree`.
+    SphericalHarmonics(double mu, double radius, const std::string& file, int degree);
+
+    ~SphericalHarmonics() {}
+
+    /// Sets the normalised coefficients of the degree `n`, order `m` term.
+    void setCoefficients(int n, int m, double C, double S);
+
+    /// Limits evaluation to terms of degree `degree` and lower. Cannot exceed the
+    /// degree the field was created with.
+    void setDegree(int degree);
+
+    /// Degree the field is currently evaluated to.
+    int degree() const { return _degree; }
+
+    /// Highest degree the field holds coefficients for.
+    int maxDegree() const { return _maxDegree; }
+
+    virtual vec3 perturbation(const vec3& at) const;
+
+private:
+
+    /// Offset of the term (n, m) in the order-major coefficient arrays.
+    int index(int n, int m) const { return _offsets[m] + (n - m); }
+
+    /// Offset of (n, m) in the recursion arrays, which go one degree further.
+    int recursionIndex(int n, int m) const { return _recursionOffsets[m] + (n - m); }
+
+    void precompute();
+
+    double              _gravitationalParameter;
+    double              _radius;
+    int                 _maxDegree;
+    int                 _degree;
+
+    std::vector<int>    _offsets;
+    std::vector<double> _C;
+    std::vector<double> _S;
+
+    // Acceleration scale factors for the m+1, m-1 and m columns of V/W.
+    std::vector<double> _fPlus;
+    std::vector<double> _fMinus;
+    std::vector<double> _fZ;
+
+    // Cunningham recursion coefficients, degree 0 through maxDegree+1.
+    std::vector<int>    _recursionOffsets;
+    std::vector<double> _a;
+    std::vector<double> _b;
+    std::vector<double> _diagonal;
+};
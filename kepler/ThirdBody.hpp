@@ -0,0 +1,63 @@
+//
+//  ThirdBody.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <memory>
+#include <string>
+#include "Ephemeris.hpp"
+
+/// A distant body (Sun, Moon...) perturbing orbits around a MassiveBody. The
+/// perturbation is the difference between the body's pull on the spacecraft and
+/// its pull on the central body, which both only depend on time through the
+/// ephemeris. They are sampled once per epoch, so each evaluation only costs a
+/// difference, a square root and a handful of multiplications.
+class ThirdBody final {
+public:
+    
+    /// Third-body state at one epoch, shared by every evaluation at that epoch.
+    struct Sample {
+        vec3 position;
+        vec3 indirect;
+    };
+    
+    ThirdBody(const std::string& name, double mu, std::shared_ptr<const Ephemeris> ephemeris) :
+        _name(name),
+        _gravitationalParameter(mu),
+        _ephemeris(ephemeris) {}
+    
+    ~ThirdBody() {}
+    
+    /// Looks up the body's position relative to the central body.
+    Sample sample(double epoch) const {
+        auto s = _ephemeris->position(epoch);
+        double d = s.magnitude();
+        return Sample{s, s * (_gravitationalParameter / (d*d*d))};
+    }
+    
+    /// Perturbing acceleration at `at`, relative to the central body's centre.
+    template <typename T>
+    vec<T, 3> acceleration(const Sample& sample, const vec<T, 3>& at) const {
+        using std::sqrt;
+        auto ray = vec<T, 3>(sample.position) - at;
+        T d2 = dot(ray, ray);
+        T d = sqrt(d2);
+        return ray * (_gravitationalParameter / (d2*d)) - vec<T, 3>(sample.indirect);
+    }
+    
+    const std::string& name() const { return _name; }
+    
+    double gravitationalParameter() const { return _gravitationalParameter; }
+    
+    const Ephemeris& ephemeris() const { return *_ephemeris; }
+    
+private:
+    
+    std::string                         _name;
+    double                              _gravitationalParameter;
+    std::shared_ptr<const Ephemeris>    _ephemeris;
+};
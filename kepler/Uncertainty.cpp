@@ -0,0 +1,120 @@
+//
+//  Uncertainty.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include "Uncertainty.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/// Stands in for the body, with the state being propagated.
+struct Carrier final : SolidBody {
+    
+    Carrier(const SolidBody& body, const State& state) : body(body), state(state) {}
+    
+    virtual State stateVectors() const { return state; }
+    virtual double mass() const { return body.mass(); }
+    virtual vec3 forces() const { return body.forces(); }
+    virtual double dragCoefficient() const { return body.dragCoefficient(); }
+    virtual double surfaceArea() const { return body.surfaceArea(); }
+    virtual double reflectivity() const { return body.reflectivity(); }
+    
+    const SolidBody&    body;
+    State               state;
+};
+
+UncertaintyPropagator::UncertaintyPropagator(const MassiveBody& planet, const SolidBody& body, Mode mode) :
+_planet(planet),
+_body(body),
+_mode(mode)
+{
+    
+}
+
+Uncertainty UncertaintyPropagator::propagate(const Uncertainty& initial, double epoch, double duration, double dt) {
+    if(dt <= 0) { throw std::runtime_error("Propagation step must be positive"); }
+    return _mode == Mode::linear
+        ? linear(initial, epoch, duration, dt)
+        : unscented(initial, epoch, duration, dt);
+}
+
+Uncertainty UncertaintyPropagator::linear(const Uncertainty& initial, double epoch, double duration, double dt) {
+    Carrier carrier(_body, initial.mean);
+    auto transition = mat66::identity();
+    Clock clock{Epoch(epoch)};
+    for(double left = duration; left > 0; left = duration - clock.elapsed()) {
+        double step = std::min(dt, left);
+        carrier.state = _integrator.advanceState(carrier, _planet, clock.now().value(), step, transition);
+        clock.advance(step);
+    }
+    // P = Φ P₀ Φᵀ, in place.
+    mat66 mapped, covariance;
+    multiply(transition, initial.covariance, mapped);
+    multiply(mapped, transition.transpose(), covariance);
+    return Uncertainty{carrier.state, covariance};
+}
+
+Uncertainty UncertaintyPropagator::unscented(const Uncertainty& initial, double epoch, double duration, double dt) {
+    const int n = 6;
+    const int points = 2 * n + 1;
+    
+    double lambda = alpha * alpha * (n + kappa) - n;
+    auto spread = Cholesky<n>(initial.covariance * (n + lambda)).lower;
+    
+    // Sigma points: the mean, then the mean plus and minus each column of the spread.
+    double mean[n] = {
+        initial.mean.p.x, initial.mean.p.y, initial.mean.p.z,
+        initial.mean.v.x, initial.mean.v.y, initial.mean.v.z,
+    };
+    double sigma[points][n];
+    for(int i = 0; i < n; ++i) {
+        for(int k = 0; k < points; ++k) { sigma[k][i] = mean[i]; }
+        for(int j = 0; j < n; ++j) {
+            sigma[1 + j][i] += spread[i][j];
+            sigma[1 + n + j][i] -= spread[i][j];
+        }
+    }
+    
+    // Each sigma point is a trajectory of its own, integrated exactly as the nominal one.
+    for(int k = 0; k < points; ++k) {
+        Carrier carrier(_body, State(vec3{sigma[k][0], sigma[k][1], sigma[k][2]},
+                                     vec3{sigma[k][3], sigma[k][4], sigma[k][5]}));
+        Clock clock{Epoch(epoch)};
+        for(double left = duration; left > 0; left = duration - clock.elapsed()) {
+            double step = std::min(dt, left);
+            carrier.state = _integrator.advanceState(carrier, _planet, clock.now().value(), step);
+            clock.advance(step);
+        }
+        const State& s = carrier.state;
+        double final[n] = {s.p.x, s.p.y, s.p.z, s.v.x, s.v.y, s.v.z};
+        std::copy(final, final + n, sigma[k]);
+    }
+    
+    // Recombine with the unscented weights.
+    double meanWeight = lambda / (n + lambda);
+    double covarianceWeight = meanWeight + (1 - alpha * alpha + beta);
+    double weight = 1 / (2 * (n + lambda));
+    
+    double result[n];
+    for(int i = 0; i < n; ++i) {
+        result[i] = meanWeight * sigma[0][i];
+        for(int k = 1; k < points; ++k) { result[i] += weight * sigma[k][i]; }
+    }
+    
+    mat66 covariance;
+    for(int i = 0; i < n; ++i) {
+        for(int j = 0; j <= i; ++j) {
+            double sum = 0;
+            for(int k = 0; k < points; ++k) {
+                double w = k ? weight : covarianceWeight;
+                sum += w * (sigma[k][i] - result[i]) * (sigma[k][j] - result[j]);
+            }
+            covariance[i][j] = covariance[j][i] = sum;
+        }
+    }
+    
+    return Uncertainty{State(vec3{result[0], result[1], result[2]}, vec3{result[3], result[4], result[5]}), covariance};
+}
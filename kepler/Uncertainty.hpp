@@ -0,0 +1,60 @@
+//
+//  Uncertainty.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include "physics.hpp"
+#include "SolidBody.hpp"
+#include "MassiveBody.hpp"
+#include "RK4.hpp"
+
+/// Mean state and its 6×6 covariance, position components first.
+struct Uncertainty {
+    State   mean;
+    mat66   covariance;
+};
+
+/// Propagates a state's uncertainty along with the state itself, in one of two modes:
+///
+/// - `linear`: the mean follows the full force pipeline, and the covariance is
+///   mapped through the state transition matrix integrated alongside it
+///   (P = Φ P₀ Φᵀ). Costs about three nominal runs, but assumes the dynamics stay
+///   linear across the spread of the distribution.
+/// - `unscented`: the 2n+1 = 13 sigma points of the distribution are propagated
+///   through the same force pipeline, then recombined into a mean and covariance.
+///   This captures non-linear growth, such as along-track spread, for the cost of
+///   13 nominal runs.
+class UncertaintyPropagator {
+public:
+    
+    enum class Mode {
+        linear,
+        unscented,
+    };
+    
+    /// `body` provides the drag parameters; its own state is not used.
+    UncertaintyPropagator(const MassiveBody& planet, const SolidBody& body, Mode mode);
+    
+    /// Propagates from `epoch` to `epoch + duration`, in steps of at most `dt`.
+    Uncertainty propagate(const Uncertainty& initial, double epoch, double duration, double dt);
+    
+    /// Unscented transform spread (alpha), prior knowledge (beta) and secondary
+    /// scaling (kappa) parameters.
+    double  alpha = 1;
+    double  beta = 2;
+    double  kappa = 0;
+    
+private:
+    
+    Uncertainty linear(const Uncertainty& initial, double epoch, double duration, double dt);
+    Uncertainty unscented(const Uncertainty& initial, double epoch, double duration, double dt);
+    
+    const MassiveBody&  _planet;
+    const SolidBody&    _body;
+    Mode                _mode;
+    RK4                 _integrator;
+};
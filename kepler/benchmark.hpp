@@ -0,0 +1,52 @@
+//
+//  benchmark.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*!
+ * @brief       Calls a function repeatedly for (at least) a given duration.
+ * @param       fn          Function to benchmark. Its result is consumed so the
+ *                          call cannot be optimised away.
+ * @param       seconds     Minimum wall-clock time to spend in the benchmark.
+ * @return      The number of calls per second.
+ */
+template <typename F>
+double throughput(F fn, double seconds = 0.25) {
+    using clock = std::chrono::steady_clock;
+    volatile double sink = 0;
+    std::uint64_t calls = 0;
+    std::uint64_t batch = 1;
+    auto start = clock::now();
+    double elapsed = 0;
+    
+    while(elapsed < seconds) {
+        for(std::uint64_t i = 0; i < batch; ++i) {
+            sink = sink + double(fn());
+        }
+        calls += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    (void)sink;
+    return calls / elapsed;
+}
+
+/// Prints one benchmark result line.
+inline void report(const std::string& name, double perSecond) {
+    auto precision = std::cout.precision();
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+              << perSecond << " /s" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(precision);
+}
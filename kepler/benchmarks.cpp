@@ -0,0 +1,1021 @@
+//
+//  benchmarks.cpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+#include "benchmarks.hpp"
+#include "benchmark.hpp"
+#include "MassiveBody.hpp"
+#include "SphericalHarmonics.hpp"
+#include "GravityGrid.hpp"
+#include "ThirdBody.hpp"
+#include "SolarRadiation.hpp"
+#include "PlanetarySystem.hpp"
+#include "NBody.hpp"
+#include "ForceModels.hpp"
+#include "RK4.hpp"
+#include "LaunchVehicle.hpp"
+#include "Orbit.hpp"
+#include "AscentOptimizer.hpp"
+#include "Uncertainty.hpp"
+#include "expression.hpp"
+#include "quaternion.hpp"
+
+/// Minimal spacecraft for benchmarks.
+struct Probe : SolidBody {
+    State   state;
+    vec3    thrust;
+    
+    virtual State stateVectors() const { return state; }
+    virtual double mass() const { return 1000; }
+    virtual vec3 forces() const { return thrust; }
+    virtual double dragCoefficient() const { return 2.2; }
+    virtual double surfaceArea() const { return 10; }
+    virtual double reflectivity() const { return 1.3; }
+};
+
+/// Synthetic Earth-sized field following Kaula's rule, so magnitudes are realistic.
+static std::shared_ptr<SphericalHarmonics> syntheticField(int degree) {
+    auto field = std::make_shared<SphericalHarmonics>(3.986004418e14, 6378.1363e3, degree);
+    std::mt19937 rng{42};
+    std::normal_distribution<double> noise{0, 1};
+    for(int n = 2; n <= degree; ++n) {
+        for(int m = 0; m <= n; ++m) {
+            double sigma = 1e-5 / (n * n);
+            field->setCoefficients(n, m, sigma * noise(rng), sigma * noise(rng));
+        }
+    }
+    return field;
+}
+
+static void benchmarkHarmonics() {
+    std::cout << "==== spherical harmonics ====" << std::endl;
+    
+    auto field = syntheticField(360);
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    vec3 at{4059608.89, -1528891.74, 5202483.96};
+    report("point mass", throughput([&]() { return earth.gravity(at).x; }));
+    
+    for(int degree : {2, 4, 8, 16, 32, 70, 120, 180, 360}) {
+        field->setDegree(degree);
+        report("degree " + std::to_string(degree),
+               throughput([&]() { return field->perturbation(at).x; }));
+    }
+    std::cout << std::endl;
+}
+
+static void benchmarkGravityGrid() {
+    std::cout << "==== gravity grid (degree 70 source) ====" << std::endl;
+    
+    auto field = syntheticField(70);
+    GravityGrid grid{field, 6500e3, 7500e3, 64, 180, 360};
+    vec3 at{4059608.89, -1528891.74, 5202483.96};
+    
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<double> jitter{-20e3, 20e3};
+    double worst = 0;
+    for(int i = 0; i < 1000; ++i) {
+        vec3 p = at + vec3{jitter(rng), jitter(rng), jitter(rng)};
+        vec3 exact = field->perturbation(p);
+        worst = max(worst, (grid.perturbation(p) - exact).magnitude() / exact.magnitude());
+    }
+    std::cout << "tiles built: " << grid.tilesBuilt() << "/" << grid.tileCount()
+              << ", worst relative error: " << worst << std::endl;
+    
+    report("harmonics, degree 70", throughput([&]() { return field->perturbation(at).x; }));
+    report("grid lookup", throughput([&]() { return grid.perturbation(at).x; }));
+    std::cout << std::endl;
+}
+
+static void benchmarkThirdBody() {
+    std::cout << "==== third body (lunar ephemeris) ====" << std::endl;
+    
+    // Circular, inclined lunar orbit tabulated on 4-day segments.
+    auto moonPosition = [](double t) {
+        double n = 2.0 * M_PI / (27.321661 * 86400.0);
+        double i = radians(5.145);
+        return vec3{std::cos(n*t), std::sin(n*t) * std::cos(i), std::sin(n*t) * std::sin(i)} * 384400e3;
+    };
+    auto ephemeris = std::make_shared<Ephemeris>(Ephemeris::fit(moonPosition, 0, 30 * 86400.0, 4 * 86400.0, 13));
+    ThirdBody moon{"Moon", 4.9048695e12, ephemeris};
+    
+    double worst = 0;
+    for(double t = 0; t < 30 * 86400.0; t += 3607.0) {
+        worst = max(worst, (ephemeris->position(t) - moonPosition(t)).magnitude());
+    }
+    std::cout << "worst fit error: " << worst << "m" << std::endl;
+    
+    vec3 at{4059608.89, -1528891.74, 5202483.96};
+    double epoch = 12345.0;
+    auto sample = moon.sample(epoch);
+    report("ephemeris sample (Clenshaw)", throughput([&]() { epoch += 1e-3; return moon.sample(epoch).position.x; }));
+    report("perturbation from sample", throughput([&]() { return moon.acceleration(sample, at).x; }));
+    std::cout << std::endl;
+}
+
+static void benchmarkSolarRadiation() {
+    std::cout << "==== solar radiation pressure ====" << std::endl;
+    
+    auto sunPosition = [](double t) {
+        double n = 2.0 * M_PI / (365.25 * 86400.0);
+        return vec3{std::cos(n*t), std::sin(n*t), 0} * SolarRadiation::astronomicalUnit;
+    };
+    auto ephemeris = std::make_shared<Ephemeris>(Ephemeris::fit(sunPosition, 0, 30 * 86400.0, 8 * 86400.0, 10));
+    auto sun = std::make_shared<ThirdBody>("Sun", 1.32712440018e20, ephemeris);
+    SolarRadiation radiation{sun};
+    
+    const double radius = 6371e3;
+    auto geometry = radiation.sample(0, radius);
+    
+    // Fraction of a geostationary orbit spent in (partial) shadow.
+    const int samples = 100000;
+    int shadowed = 0, umbra = 0;
+    for(int i = 0; i < samples; ++i) {
+        double angle = 2.0 * M_PI * i / samples;
+        double lit = radiation.illumination(geometry, vec3{std::cos(angle), std::sin(angle), 0} * 42164e3, radius);
+        shadowed += lit < 1;
+        umbra += lit == 0;
+    }
+    std::cout << "GEO in shadow: " << 100.0 * shadowed / samples << "%, in umbra: "
+              << 100.0 * umbra / samples << "%" << std::endl;
+    
+    vec3 day{42164e3, 0, 0};
+    vec3 night{-42164e3, 1e6, 0};
+    vec3 terminator{-42164e3, radius, 0};
+    report("sunlit", throughput([&]() { return radiation.acceleration(geometry, day, radius, 0.01, 1.3).x; }));
+    report("night side, outside penumbra", throughput([&]() {
+        return radiation.acceleration(geometry, day + vec3{-84328e3, 3e7, 0}, radius, 0.01, 1.3).x;
+    }));
+    report("umbra", throughput([&]() { return radiation.acceleration(geometry, night, radius, 0.01, 1.3).x; }));
+    report("penumbra", throughput([&]() { return radiation.acceleration(geometry, terminator, radius, 0.01, 1.3).x; }));
+    std::cout << std::endl;
+}
+
+static void benchmarkPatchedConics() {
+    std::cout << "==== patched conics (Kerbin system) ====" << std::endl;
+    
+    auto kerbin = std::make_shared<MassiveBody>("Kerbin", 3600*6, 600e3, 3.5316e12, 1.221, 5.6e3, 70e3);
+    auto mun = std::make_shared<MassiveBody>("Mun", 138984.38, 200e3, 6.5138398e10, 0, 1, 0);
+    auto minmus = std::make_shared<MassiveBody>("Minmus", 40400, 60e3, 1.7658e9, 0, 1, 0);
+    PlanetarySystem system;
+    system.addRoot(kerbin);
+    int m = system.add(mun, 0, Orbit(*kerbin, 12000e3, 0, 0, 0, 0, 97.4));
+    system.add(minmus, 0, Orbit(*kerbin, 47000e3, 0, 6, 38, 78, 52.4));
+    
+    auto at = system.stateVectors(m, 0).p + vec3{500e3, 0, 0};
+    std::cout << "Mun SoI: " << system.sphereOfInfluence(m)/1000.0 << "km, dominant body near the Mun: "
+              << system.body(system.dominantBody(at, 0)).name() << std::endl;
+    
+    // Hohmann transfer from a 100km parking orbit, timed so apoapsis falls just
+    // short of the Mun: the probe enters its sphere, flies by and leaves again.
+    const double mu = kerbin->gravitationalParameter();
+    const double parking = 700e3, a = (parking + 11000e3) / 2;
+    const double flight = M_PI * std::sqrt(a * a * a / mu), dt = 10, duration = 40000;
+    auto arrival = system.stateVectors(m, flight);
+    auto outward = arrival.p * (-1.0 / arrival.p.magnitude());
+    auto normal = vec3::cross(arrival.p, arrival.v);
+    auto prograde = vec3::cross(normal * (1.0 / normal.magnitude()), outward);
+    const State departure(outward * parking, prograde * std::sqrt(mu * (2 / parking - 1 / a)));
+    
+    RK4 integrator;
+    auto transfer = [&](bool log) {
+        Probe probe;
+        probe.state = departure;
+        int central = 0;
+        double closest = INFINITY;
+        for(double t = 0; t < duration; t += dt) {
+            int previous = central;
+            probe.state = system.advance(integrator, probe, central, t, dt);
+            if(central == m) { closest = std::min(closest, probe.state.p.magnitude()); }
+            if(log && central != previous) {
+                std::cout << "t=" << t + dt << "s: " << system.body(previous).name() << " -> "
+                          << system.body(central).name() << std::endl;
+            }
+        }
+        if(log) { std::cout << "closest approach to the Mun: " << closest/1000.0 << "km" << std::endl; }
+        return probe.state.p.x;
+    };
+    transfer(true);
+    report("Kerbin only, 10s RK4 steps", throughput([&]() {
+        Probe probe;
+        probe.state = departure;
+        for(double t = 0; t < duration; t += dt) { probe.state = integrator.advanceState(probe, *kerbin, t, dt); }
+        return probe.state.p.x;
+    }));
+    report("Mun flyby with handoffs, 10s RK4 steps", throughput([&]() { return transfer(false); }));
+    std::cout << std::endl;
+}
+
+static void benchmarkNBody() {
+    std::cout << "==== N-body ====" << std::endl;
+    
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<double> spread{-1e11, 1e11};
+    for(int count : {64, 512, 4096}) {
+        NBody direct, tree;
+        for(int i = 0; i < count; ++i) {
+            State s{vec3{spread(rng), spread(rng), spread(rng)}, vec3{0}};
+            direct.add(s, 1e12);
+            tree.add(s, 1e12);
+        }
+        direct.setTreeThreshold(count);
+        tree.setTreeThreshold(0);
+        
+        std::vector<vec3> exact, approximate;
+        direct.accelerations(exact);
+        tree.accelerations(approximate);
+        double worst = 0;
+        for(int i = 0; i < count; ++i) {
+            worst = max(worst, (exact[i] - approximate[i]).magnitude() / exact[i].magnitude());
+        }
+        std::cout << count << " bodies, worst tree error: " << worst << std::endl;
+        
+        std::vector<vec3> out;
+        report("direct sum, " + std::to_string(count) + " bodies",
+               throughput([&]() { direct.accelerations(out); return out[0].x; }));
+        report("Barnes-Hut, " + std::to_string(count) + " bodies",
+               throughput([&]() { tree.accelerations(out); return out[0].x; }));
+    }
+    std::cout << std::endl;
+}
+
+static void benchmarkForceModels() {
+    std::cout << "==== force models (per stage) ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    auto moon = [](double t) {
+        double n = 2.0 * M_PI / (27.321661 * 86400.0);
+        return vec3{std::cos(n*t), std::sin(n*t), 0} * 384400e3;
+    };
+    auto sun = [](double t) {
+        double n = 2.0 * M_PI / (365.25 * 86400.0);
+        return vec3{std::cos(n*t), std::sin(n*t), 0} * SolarRadiation::astronomicalUnit;
+    };
+    auto sunBody = std::make_shared<ThirdBody>("Sun", 1.32712440018e20,
+        std::make_shared<Ephemeris>(Ephemeris::fit(sun, 0, 10 * 86400.0, 8 * 86400.0, 10)));
+    earth.addThirdBody(sunBody);
+    earth.addThirdBody(std::make_shared<ThirdBody>("Moon", 4.9048695e12,
+        std::make_shared<Ephemeris>(Ephemeris::fit(moon, 0, 10 * 86400.0, 4 * 86400.0, 13))));
+    earth.setSolarRadiation(std::make_shared<SolarRadiation>(sunBody));
+    
+    Probe probe;
+    probe.state = State(vec3{6571e3, 0, 0}, vec3{0, 7788, 0});
+    probe.thrust = vec3{0, 1000, 0};
+    double epochs[] = {100.0};
+    BodyProperties properties(probe);
+    StageContext context(properties, earth, probe.state, epochs[0], 0);
+    
+    Gravity gravity;
+    Drag drag;
+    Thrust thrust;
+    ThirdBodies thirdBodies;
+    RadiationPressure radiation;
+    thirdBodies.prepare(earth, epochs, 1);
+    radiation.prepare(earth, epochs, 1);
+    StandardForces forces;
+    forces.prepare(earth, epochs, 1);
+    
+    report("stage context", throughput([&]() { return StageContext(properties, earth, probe.state, 100.0, 0).speed; }));
+    report("gravity", throughput([&]() { return gravity.acceleration(context).x; }));
+    report("drag", throughput([&]() { return drag.acceleration(context).x; }));
+    report("thrust", throughput([&]() { return thrust.acceleration(context).x; }));
+    report("third bodies (Sun, Moon)", throughput([&]() { return thirdBodies.acceleration(context).x; }));
+    report("radiation pressure", throughput([&]() { return radiation.acceleration(context).x; }));
+    report("standard pipeline", throughput([&]() { return forces.acceleration(context).x; }));
+    
+    RK4 integrator;
+    double epoch = 0;
+    report("RK4 step, standard pipeline", throughput([&]() {
+        epoch += 1e-3;
+        return integrator.advanceState(probe, earth, epoch, 0.1).p.x;
+    }));
+    report("RK4 step, with integrated mass", throughput([&]() {
+        epoch += 1e-3;
+        return integrator.advanceState(probe, earth, epoch, 0.1, MassState(probe.state, 1000), -1).p.x;
+    }));
+    std::cout << std::endl;
+}
+
+static void benchmarkMultiRate() {
+    std::cout << "==== multi-rate forces (degree 70 field, Moon) ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    earth.setGravityField(syntheticField(70));
+    auto moon = [](double t) {
+        double n = 2.0 * M_PI / (27.321661 * 86400.0);
+        return vec3{std::cos(n*t), std::sin(n*t), 0} * 384400e3;
+    };
+    earth.addThirdBody(std::make_shared<ThirdBody>("Moon", 4.9048695e12,
+        std::make_shared<Ephemeris>(Ephemeris::fit(moon, 0, 10 * 86400.0, 4 * 86400.0, 13))));
+    
+    // One revolution of a 300km orbit, inclined so the field's tesserals matter.
+    const State start(vec3{6671e3, 0, 0}, vec3{0, 7726 * std::cos(0.9), 7726 * std::sin(0.9)});
+    const double dt = 1;
+    const int steps = 5420;
+    auto propagate = [&](RK4& integrator) {
+        Probe probe;
+        probe.state = start;
+        for(int i = 0; i < steps; ++i) {
+            probe.state = integrator.advanceState(probe, earth, i * dt, dt);
+        }
+        return probe.state;
+    };
+    
+    RK4 reference;
+    auto exact = propagate(reference);
+    for(double period : {5.0, 30.0, 120.0}) {
+        auto forces = std::make_shared<MultiRateForces>(CentralGravity(), Drag(), Thrust(), RadiationPressure(),
+                                                        Sampled<FieldGravity>(period),
+                                                        Sampled<ThirdBodies>(period));
+        RK4 integrator(forces);
+        auto state = propagate(integrator);
+        std::cout << "perturbations every " << period << "s: " << (state.p - exact.p).magnitude()
+                  << "m from single-rate after one orbit" << std::endl;
+        report("one orbit, perturbations every " + std::to_string(int(period)) + "s",
+               throughput([&]() {
+                   forces->term<4>().reset();
+                   forces->term<5>().reset();
+                   return propagate(integrator).p.x;
+               }, 1.0));
+    }
+    report("one orbit, single rate", throughput([&]() { return propagate(reference).p.x; }, 1.0));
+    std::cout << std::endl;
+}
+
+/// Two-stage medium-lift vehicle out of the Cape.
+static Vehicle ascentVehicle(const MassiveBody& earth, const Guidance& first, const Guidance& second) {
+    std::vector<Stage> stages{
+        Stage{25.6e3, 395.7e3, Engine(7607e3, 282, 311), first},
+        Stage{3.9e3, 92.67e3, Engine(934e3, 100, 348), second},
+    };
+    Vehicle vehicle(stages, 10e3, 10.5, 0.3);
+    auto pad = earth.cartesian(MassiveBody::coordinates{28.562106, -80.577180, 0});
+    vehicle.setState(State(pad, earth.inertialVelocity(pad)));
+    return vehicle;
+}
+
+static void benchmarkAscent() {
+    std::cout << "==== launch vehicle ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    RK4 integrator;
+    GravityTurn turn(60, radians(4), radians(90));
+    Guidance inlined(turn);
+    Guidance wrapped(GNC([&](const State& state, double, double) { return turn(earth, state); }));
+    Guidance program(PitchProgram({{10, 0}, {20, radians(5)}, {90, radians(35)}, {160, radians(65)}, {400, radians(88)}},
+                                  radians(90)));
+    
+    Engine upper(934e3, 100, 348);
+    double parking = earth.radius() + 200e3;
+    
+    // Six degrees of freedom: a 40m-long, 3.6m-wide cylinder that has to turn itself
+    // towards what guidance asks, starting upright on the pad.
+    auto rigid = std::make_shared<RigidBody>(mat33{134, 0, 0, 0, 134, 0, 0, 0, 1.6}, AttitudeControl{1.5, 0.8, 0.5});
+    
+    // Flies until the last stage burns out or guidance cuts the engine off.
+    auto fly = [&](const Guidance& first, const Guidance& second, bool sixDOF = false) {
+        auto vehicle = ascentVehicle(earth, first, second);
+        if(sixDOF) {
+            auto up = earth.up(vehicle.stateVectors().p);
+            vehicle.setRigidBody(rigid, Attitude(quat::between(RigidBody::thrustAxis(), up), vec3{0.0}));
+        }
+        double t = 0;
+        do {
+            vehicle.step(integrator, earth, t, 0.1);
+            t += 0.1;
+        } while(vehicle.burning() && vehicle.throttle() > 0);
+        return vehicle;
+    };
+    
+    auto vehicle = fly(inlined, inlined);
+    for(const auto& event : vehicle.events()) {
+        std::cout << "stage " << event.stage << " separation at T+" << event.time << "s, "
+                  << earth.altitude(event.state.p) / 1e3 << "km" << std::endl;
+    }
+    
+    for(double period : {0.1, 1.0, 5.0}) {
+        PEG peg(parking, parking, upper.thrust(0), upper.Isp(0) * 9.81, period);
+        auto closedLoop = fly(inlined, peg);
+        auto state = closedLoop.stateVectors();
+        Orbit orbit(earth, state.p, state.v);
+        std::cout << "PEG every " << period << "s: cutoff at T+" << closedLoop.missionTime() << "s, "
+                  << (orbit.periapsis() - earth.radius()) / 1e3 << " x "
+                  << (orbit.apoapsis() - earth.radius()) / 1e3 << "km" << std::endl;
+        report("two-stage ascent, PEG every " + std::to_string(period).substr(0, 3) + "s",
+               throughput([&]() { return fly(inlined, peg).missionTime(); }, 1.0));
+    }
+    
+    State state(earth.cartesian(MassiveBody::coordinates{28.5, -80.5, 10e3}), vec3{0, 0, 300});
+    double met = 0;
+    report("guidance call, gravity turn", throughput([&]() { met += 1e-3; return inlined(earth, state, met, 1e5).attitude.x; }));
+    report("guidance call, std::function", throughput([&]() { met += 1e-3; return wrapped(earth, state, met, 1e5).attitude.x; }));
+    report("guidance call, pitch program", throughput([&]() { met += 1e-3; return program(earth, state, met, 1e5).attitude.x; }));
+    report("two-stage ascent, gravity turn", throughput([&]() { return fly(inlined, inlined).missionTime(); }, 1.0));
+    report("two-stage ascent, std::function", throughput([&]() { return fly(wrapped, wrapped).missionTime(); }, 1.0));
+    
+    PEG peg(parking, parking, upper.thrust(0), upper.Isp(0) * 9.81, 1.0);
+    for(bool sixDOF : {false, true}) {
+        auto flown = fly(inlined, peg, sixDOF);
+        auto state = flown.stateVectors();
+        Orbit orbit(earth, state.p, state.v);
+        std::cout << (sixDOF ? "6-DOF" : "3-DOF") << ": cutoff at T+" << flown.missionTime() << "s, "
+                  << (orbit.periapsis() - earth.radius()) / 1e3 << " x "
+                  << (orbit.apoapsis() - earth.radius()) / 1e3 << "km";
+        if(sixDOF) {
+            std::cout << ", " << flown.attitudeSubsteps() / (flown.missionTime() / 0.1) << " attitude sub-steps per step";
+        }
+        std::cout << std::endl;
+    }
+    report("two-stage ascent, PEG, 3-DOF", throughput([&]() { return fly(inlined, peg).missionTime(); }, 1.0));
+    report("two-stage ascent, PEG, 6-DOF", throughput([&]() { return fly(inlined, peg, true).missionTime(); }, 1.0));
+    std::cout << std::endl;
+}
+
+static void benchmarkAscentOptimizer() {
+    std::cout << "==== ascent optimisation ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    auto vehicle = ascentVehicle(earth, Guidance(), Guidance());
+    double parking = earth.radius() + 200e3;
+    Orbit target(earth, parking, 0, 40, 0, 0, 0);
+    
+    for(int threads : {1, 0}) {
+        AscentOptimizer::Settings settings;
+        settings.threads = threads;
+        AscentOptimizer optimizer(earth, vehicle, target, settings);
+        
+        auto start = std::chrono::steady_clock::now();
+        auto result = optimizer.optimize();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        const auto& best = result.best;
+        Orbit orbit(earth, best.state.p, best.state.v);
+        std::cout << (threads ? std::to_string(threads) : "all") << " thread(s): "
+                  << result.evaluations << " ascents, " << result.generations << " generations in "
+                  << elapsed << "s" << std::endl;
+        std::cout << "  kick " << best.parameters.kickSpeed << "m/s by " << degrees(best.parameters.kickAngle)
+                  << " deg, azimuth " << degrees(best.parameters.azimuth) << " deg: "
+                  << best.propellant / 1e3 << "t burned, "
+                  << (orbit.periapsis() - earth.radius()) / 1e3 << " x " << (orbit.apoapsis() - earth.radius()) / 1e3
+                  << "km at " << orbit.inclination() << " deg" << std::endl;
+        report("ascent evaluations", result.evaluations / elapsed);
+    }
+    std::cout << std::endl;
+}
+
+static void benchmarkSensitivities() {
+    std::cout << "==== sensitivities (dual numbers vs finite differences) ====" << std::endl;
+    
+    using D = dual<7>;
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    const State initial(vec3{6621e3, 0, 0}, vec3{0, 5400, 5400});
+    const int steps = 600;
+    Probe probe;
+    StandardForces forces;
+    
+    auto run = [&](const State& start, double dragCoefficient) {
+        BodyProperties body(probe);
+        body.dragCoefficient = dragCoefficient;
+        auto state = start;
+        for(int i = 0; i < steps; ++i) { state = RK4::integrate(forces, body, earth, i * 1.0, 1.0, state); }
+        return state;
+    };
+    
+    // One pass with dual numbers through the same pipeline: x, y, z, vx, vy, vz, then
+    // the drag coefficient.
+    auto sensitivities = [&]() {
+        BasicState<D> state(vec<D, 3>(D::variable(initial.p.x, 0), D::variable(initial.p.y, 1), D::variable(initial.p.z, 2)),
+                            vec<D, 3>(D::variable(initial.v.x, 3), D::variable(initial.v.y, 4), D::variable(initial.v.z, 5)));
+        BasicBodyProperties<D> body(probe.mass(), vec<D, 3>(probe.forces()), D::variable(probe.dragCoefficient(), 6),
+                                    probe.surfaceArea(), probe.reflectivity());
+        for(int i = 0; i < steps; ++i) { state = RK4::integrate(forces, body, earth, i * 1.0, 1.0, state); }
+        return state;
+    };
+    
+    // Central differences: two runs per variable.
+    auto differences = [&]() {
+        double jacobian[6][7];
+        for(int k = 0; k < 7; ++k) {
+            State plus = initial, minus = initial;
+            double cp = probe.dragCoefficient(), cm = probe.dragCoefficient();
+            double h = k < 3 ? 1.0 : (k < 6 ? 1e-3 : 1e-4);
+            if(k < 3) { plus.p.data[k] += h; minus.p.data[k] -= h; }
+            else if(k < 6) { plus.v.data[k-3] += h; minus.v.data[k-3] -= h; }
+            else { cp += h; cm -= h; }
+            auto a = run(plus, cp), b = run(minus, cm);
+            for(int i = 0; i < 3; ++i) {
+                jacobian[i][k] = (a.p.data[i] - b.p.data[i]) / (2 * h);
+                jacobian[i+3][k] = (a.v.data[i] - b.v.data[i]) / (2 * h);
+            }
+        }
+        return jacobian[0][6];
+    };
+    
+    auto exact = sensitivities();
+    auto nominal = run(initial, probe.dragCoefficient());
+    std::cout << "final position, plain vs dual: " << (nominal.p - valueOf(exact.p)).magnitude() << "m apart" << std::endl;
+    std::cout << "d(x)/d(drag coefficient): " << exact.p.x.grad[6] << " (dual), "
+              << differences() << " (finite differences)" << std::endl;
+    
+    report("nominal run", throughput([&]() { return run(initial, probe.dragCoefficient()).p.x; }));
+    report("dual-number run, 7 sensitivities", throughput([&]() { return sensitivities().p.x.value; }));
+    report("finite differences, 14 runs", throughput([&]() { return differences(); }));
+    std::cout << std::endl;
+}
+
+static void benchmarkTransitionMatrix() {
+    std::cout << "==== state transition matrix ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    RK4 integrator;
+    Probe probe;
+    const State initial(vec3{6471e3, 0, 0}, vec3{0, 5540, 5540});
+    const int steps = 600;
+    
+    auto run = [&](const State& start) {
+        probe.state = start;
+        for(int i = 0; i < steps; ++i) { probe.state = integrator.advanceState(probe, earth, i * 1.0, 1.0); }
+        return probe.state;
+    };
+    auto withTransition = [&](mat66& transition) {
+        transition = mat66::identity();
+        probe.state = initial;
+        for(int i = 0; i < steps; ++i) { probe.state = integrator.advanceState(probe, earth, i * 1.0, 1.0, transition); }
+        return probe.state;
+    };
+    // Central differences, two runs per initial state component.
+    auto differences = [&]() {
+        mat66 transition;
+        for(int k = 0; k < 6; ++k) {
+            double h = k < 3 ? 1.0 : 1e-3;
+            State plus = initial, minus = initial;
+            if(k < 3) { plus.p.data[k] += h; minus.p.data[k] -= h; }
+            else { plus.v.data[k-3] += h; minus.v.data[k-3] -= h; }
+            auto a = run(plus), b = run(minus);
+            for(int i = 0; i < 3; ++i) {
+                transition[i][k] = (a.p.data[i] - b.p.data[i]) / (2 * h);
+                transition[i+3][k] = (a.v.data[i] - b.v.data[i]) / (2 * h);
+            }
+        }
+        return transition;
+    };
+    
+    mat66 analytic;
+    auto final = withTransition(analytic);
+    auto nominal = run(initial);
+    auto numeric = differences();
+    double worst = 0;
+    for(int i = 0; i < 6; ++i) {
+        for(int j = 0; j < 6; ++j) {
+            worst = std::max(worst, std::abs(analytic[i][j] - numeric[i][j]) / (std::abs(numeric[i][j]) + 1e-3));
+        }
+    }
+    std::cout << "final position, plain vs with STM: " << (nominal.p - final.p).magnitude() << "m apart" << std::endl;
+    std::cout << "largest relative difference to finite differences: " << worst << std::endl;
+    
+    mat66 transition;
+    report("nominal run", throughput([&]() { return run(initial).p.x; }));
+    report("run with STM", throughput([&]() { return withTransition(transition).p.x; }));
+    report("finite differences, 12 runs", throughput([&]() { return differences()[0][0]; }));
+    std::cout << std::endl;
+}
+
+static void benchmarkUncertainty() {
+    std::cout << "==== uncertainty propagation ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    Probe probe;
+    Uncertainty initial;
+    initial.mean = State(vec3{6621e3, 0, 0}, vec3{0, 5480, 5480});
+    for(int i = 0; i < 6; ++i) { initial.covariance[i][i] = i < 3 ? 100.0 * 100.0 : 0.1 * 0.1; }
+    const double duration = 5400, dt = 1;
+    
+    UncertaintyPropagator linear(earth, probe, UncertaintyPropagator::Mode::linear);
+    UncertaintyPropagator unscented(earth, probe, UncertaintyPropagator::Mode::unscented);
+    auto a = linear.propagate(initial, 0, duration, dt);
+    auto b = unscented.propagate(initial, 0, duration, dt);
+    auto sigma = [](const Uncertainty& u) {
+        return std::sqrt(u.covariance[0][0] + u.covariance[1][1] + u.covariance[2][2]);
+    };
+    std::cout << "after one orbit, position sigma: " << sigma(a) << "m (linear), "
+              << sigma(b) << "m (unscented); means " << (a.mean.p - b.mean.p).magnitude() << "m apart" << std::endl;
+    
+    RK4 integrator;
+    report("nominal run, force pipeline", throughput([&]() {
+        probe.state = initial.mean;
+        for(double t = 0; t < duration; t += dt) { probe.state = integrator.advanceState(probe, earth, t, dt); }
+        return probe.state.p.x;
+    }, 1.0));
+    report("linearised (STM)", throughput([&]() { return linear.propagate(initial, 0, duration, dt).mean.p.x; }, 1.0));
+    report("unscented, 13 sigma points", throughput([&]() {
+        return unscented.propagate(initial, 0, duration, dt).mean.p.x;
+    }, 1.0));
+    std::cout << std::endl;
+}
+
+static void benchmarkExtendedPrecision() {
+    std::cout << "==== double-double reference runs ====" << std::endl;
+    
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    const State start(vec3{6621e3, 0, 0}, vec3{0, 5480, 5480});
+    const double duration = 5400, dt = 1;
+    Probe probe;
+    StandardForces forces;
+    const BodyProperties body(probe);
+    const BasicBodyProperties<ddouble> preciseBody(probe);
+    auto run = [&](auto state, const auto& properties) {
+        Clock clock;
+        while(clock.elapsed() < duration) {
+            state = RK4::integrate(forces, properties, earth, clock.now().value(), dt, state);
+            clock.advance(dt);
+        }
+        return state;
+    };
+    
+    // Same steps, same truncation error: the difference is the rounding error of the
+    // double run.
+    auto fast = run(start, body);
+    auto reference = run(BasicState<ddouble>(start.p, start.v), preciseBody);
+    std::cout << "after one orbit, double run is " << (fast.p - valueOf(reference.p)).magnitude()
+              << "m from the double-double one" << std::endl;
+    
+    report("one orbit, double", throughput([&]() { return run(start, body).p.x; }, 1.0));
+    report("one orbit, double-double", throughput([&]() {
+        return run(BasicState<ddouble>(start.p, start.v), preciseBody).p.x.hi;
+    }, 1.0));
+    std::cout << std::endl;
+}
+
+static void benchmarkExpressions() {
+    std::cout << "==== RK4 combine step (matrix operators vs fused expressions) ====" << std::endl;
+    
+    const int count = 256;
+    const double dt = 0.5;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<vec3> x(count), k[4];
+    std::vector<mat66> phi(count / 16), dphi[4];
+    for(auto& v : x) { v = vec3{uniform(rng), uniform(rng), uniform(rng)}; }
+    for(auto& m : phi) { for(auto& c : m.data) { for(auto& e : c) { e = uniform(rng); } } }
+    for(int j = 0; j < 4; ++j) {
+        k[j] = x;
+        dphi[j] = phi;
+        std::shuffle(k[j].begin(), k[j].end(), rng);
+        std::shuffle(dphi[j].begin(), dphi[j].end(), rng);
+    }
+    
+    auto plain = [&](int i) { return x[i] + (k[0][i] + 2.0*(k[1][i] + k[2][i]) + k[3][i]) / 6.0 * dt; };
+    auto plainMatrix = [&](int i) { return phi[i] + (dphi[0][i] + 2.0*(dphi[1][i] + dphi[2][i]) + dphi[3][i]) * (dt / 6.0); };
+    auto fusedMatrix = [&](int i) -> mat66 {
+        return lazy(phi[i]) + (lazy(dphi[0][i]) + 2.0*(lazy(dphi[1][i]) + dphi[2][i]) + dphi[3][i]) * (dt / 6.0);
+    };
+    
+    double worst = 0;
+    for(int i = 0; i < count / 16; ++i) { worst = std::max(worst, std::abs((plainMatrix(i) - fusedMatrix(i))[5][5])); }
+    std::cout << "largest difference, plain vs fused: " << worst << std::endl;
+    
+    report("vec3 combine, plain (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(int i = 0; i < count; ++i) { sum += plain(i); }
+        return sum.x;
+    }));
+    report("mat66 combine, plain (x16)", throughput([&]() {
+        mat66 sum;
+        for(int i = 0; i < count / 16; ++i) { sum += plainMatrix(i); }
+        return sum[0][0];
+    }));
+    report("mat66 combine, fused (x16)", throughput([&]() {
+        mat66 sum;
+        for(int i = 0; i < count / 16; ++i) { sum += fusedMatrix(i); }
+        return sum[0][0];
+    }));
+    std::cout << std::endl;
+}
+
+static void benchmarkVectors() {
+#if KEPLER_SIMD
+    std::cout << "==== vec3 arithmetic (vector units) ====" << std::endl;
+#else
+    std::cout << "==== vec3 arithmetic (scalar) ====" << std::endl;
+#endif
+    
+    const int count = 256;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(-1e7, 1e7);
+    std::vector<vec3> a(count), b(count);
+    for(int i = 0; i < count; ++i) {
+        a[i] = vec3{uniform(rng), uniform(rng), uniform(rng)};
+        b[i] = vec3{uniform(rng), uniform(rng), uniform(rng)};
+    }
+    
+    // Scalar references, written out component by component.
+    int mismatches = 0;
+    auto check = [&](const vec3& value, double x, double y, double z) {
+        if(!(value.x == x && value.y == y && value.z == z)) { ++mismatches; }
+    };
+    for(int i = 0; i < count; ++i) {
+        const vec3& p = a[i];
+        const vec3& q = b[i];
+        const double s = q.x * 1e-7;
+        check(p + q, p.x + q.x, p.y + q.y, p.z + q.z);
+        check(p - q, p.x - q.x, p.y - q.y, p.z - q.z);
+        check(p * s, p.x * s, p.y * s, p.z * s);
+        check(p / s, p.x / s, p.y / s, p.z / s);
+        check(vec3::cross(p, q), p.y*q.z - p.z*q.y, -(p.x*q.z - p.z*q.x), p.x*q.y - p.y*q.x);
+        if(dot(p, q) != (p.x*q.x + p.y*q.y) + p.z*q.z) { ++mismatches; }
+        double length = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        check(p.normalize(), p.x * (1 / length), p.y * (1 / length), p.z * (1 / length));
+    }
+    std::cout << "mismatches against scalar arithmetic: " << mismatches << " / " << 7 * count << std::endl;
+    
+    report("sum of normalised crosses (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(int i = 0; i < count; ++i) { sum += vec3::cross(a[i], b[i]).normalize(); }
+        return sum.x;
+    }));
+    report("dot products (x256)", throughput([&]() {
+        double sum = 0;
+        for(int i = 0; i < count; ++i) { sum += dot(a[i], b[i]); }
+        return sum;
+    }));
+    report("axpy, a + b * s (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(int i = 0; i < count; ++i) { sum += a[i] + b[i] * 0.5; }
+        return sum.x;
+    }));
+    std::cout << std::endl;
+}
+
+static void benchmarkDecompositions() {
+    std::cout << "==== matrix decompositions ====" << std::endl;
+    
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    mat33 a3;
+    mat66 a6;
+    for(auto& row : a3.data) { for(auto& e : row) { e = uniform(rng); } }
+    for(auto& row : a6.data) { for(auto& e : row) { e = uniform(rng); } }
+    // Normal matrices are symmetric positive definite, like covariances.
+    mat33 s3 = a3.transpose() * a3 + mat33::identity();
+    mat66 s6 = a6.transpose() * a6 + mat66::identity();
+    vec3 b3{1, 2, 3};
+    vec<double, 6> b6(1.0);
+    
+    auto residual = [](const mat66& a, const mat66& inverse) {
+        auto product = a * inverse;
+        double worst = 0;
+        for(int i = 0; i < 6; ++i) {
+            for(int j = 0; j < 6; ++j) { worst = std::max(worst, std::abs(product[i][j] - (i == j))); }
+        }
+        return worst;
+    };
+    std::cout << "6x6 inverse residual: " << residual(a6, a6.inverse()) << " (LU), "
+              << residual(s6, Cholesky<6>(s6).inverse()) << " (Cholesky)" << std::endl;
+    
+    // The matrices are nudged on every call so nothing is hoisted out of the loop.
+    report("3x3 determinant", throughput([&]() { a3[0][0] += 1e-12; return a3.determinant(); }));
+    report("3x3 LU solve", throughput([&]() { a3[0][0] += 1e-12; return LU<3>(a3).solve(b3).x; }));
+    report("3x3 Cholesky solve", throughput([&]() { s3[0][0] += 1e-12; return Cholesky<3>(s3).solve(b3).x; }));
+    report("3x3 inverse", throughput([&]() { a3[0][0] += 1e-12; return a3.inverse()[0][0]; }));
+    report("6x6 determinant", throughput([&]() { a6[0][0] += 1e-12; return a6.determinant(); }));
+    report("6x6 LU solve", throughput([&]() { a6[0][0] += 1e-12; return LU<6>(a6).solve(b6)[0]; }));
+    report("6x6 Cholesky solve", throughput([&]() { s6[0][0] += 1e-12; return Cholesky<6>(s6).solve(b6)[0]; }));
+    report("6x6 inverse", throughput([&]() { a6[0][0] += 1e-12; return a6.inverse()[0][0]; }));
+    std::cout << std::endl;
+}
+
+static void benchmarkRotations() {
+    std::cout << "==== rotations ====" << std::endl;
+    
+    const int count = 256;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<vec3> v(count);
+    for(auto& e : v) { e = vec3{uniform(rng), uniform(rng), uniform(rng)}.normalize(); }
+    const vec3 axis = vec3{uniform(rng), uniform(rng), uniform(rng)};
+    const double angle = 0.7;
+    
+    // Agreement of the three ways of applying the same rotation, and of the conversions.
+    const quat q = quat::axisAngle(axis, angle);
+    const mat33 m = q.rotationMatrix();
+    const quat back = quat::fromMatrix(m);
+    double worst = 0;
+    for(const auto& e : v) {
+        worst = std::max(worst, (q.rotate(e) - e.rotate(axis, angle)).magnitude());
+        worst = std::max(worst, (m * e - e.rotate(axis, angle)).magnitude());
+    }
+    std::cout << "largest difference with vec3::rotate: " << worst << std::endl;
+    std::cout << "matrix round trip error: " << (back + -q).magnitude() << ", slerp(0.5) angle error: "
+              << std::abs(2 * std::acos(slerp(quat(), q, 0.5).w) - 0.5 * angle) << std::endl;
+    
+    report("vec3::rotate (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(const auto& e : v) { sum += e.rotate(axis, angle); }
+        return sum.x;
+    }));
+    report("quat::rotate (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(const auto& e : v) { sum += q.rotate(e); }
+        return sum.x;
+    }));
+    report("quat as mat33 (x256)", throughput([&]() {
+        vec3 sum{0};
+        for(const auto& e : v) { sum += m * e; }
+        return sum.x;
+    }));
+    
+    // Heading and pitch to a direction, as guidance does once per step.
+    auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
+    auto local = earth.localGeometry(vec3{6.471e6, 1e5, 2e5});
+    double heading = 0;
+    report("two chained vec3::rotate", throughput([&]() {
+        heading += 1e-6;
+        return local.north.rotate(local.east, radians(10.0)).rotate(local.up, -radians(heading)).x;
+    }));
+    report("MassiveBody::heading (quat)", throughput([&]() {
+        heading += 1e-6;
+        return earth.heading(local, heading, 10.0).x;
+    }));
+    std::cout << std::endl;
+}
+
+/// Textbook dot-product matrix multiply, as a reference.
+template <int a, int b, int c>
+static void naiveProduct(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p) {
+    for(int i = 0; i < a; ++i) {
+        for(int j = 0; j < c; ++j) {
+            double temp = 0;
+            for(int k = 0; k < b; ++k) { temp += lhs[i][k] * rhs[k][j]; }
+            p[i][j] = temp;
+        }
+    }
+}
+
+template <int n>
+static void benchmarkProduct(const std::string& name, std::mt19937& rng, double seconds = 0.25) {
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::unique_ptr<matrix<n, n>[]> m(new matrix<n, n>[3]);
+    for(auto& row : m[0].data) { for(auto& e : row) { e = uniform(rng); } }
+    
+    // Products are chained through an orthogonal matrix (the Cayley transform of a
+    // skew-symmetric one): every element of every product is then needed, so none of
+    // the work can be optimised away, and values neither grow nor vanish.
+    std::unique_ptr<matrix<n, n>[]> skew(new matrix<n, n>[2]);
+    for(int i = 0; i < n; ++i) {
+        for(int j = 0; j < i; ++j) {
+            skew[0][i][j] = uniform(rng);
+            skew[0][j][i] = -skew[0][i][j];
+        }
+    }
+    skew[1] = matrix<n, n>::identity() - skew[0];
+    skew[0] += matrix<n, n>::identity();
+    m[1] = LU<n>(skew[1]).solve(skew[0]);
+    
+    naiveProduct(m[0], m[1], m[2]);
+    auto fast = m[0] * m[1];
+    bool same = std::equal(&fast.data[0][0], &fast.data[0][0] + n * n, &m[2].data[0][0]);
+    std::cout << name << " product matches the textbook loop: " << (same ? "yes" : "NO") << std::endl;
+    
+    int current = 0;
+    report(name + " textbook loop", throughput([&]() {
+        naiveProduct(m[current], m[1], m[2 - current]);
+        current = 2 - current;
+        return m[current][0][0];
+    }, seconds));
+    report(name + " operator*", throughput([&]() {
+        m[2 - current] = m[current] * m[1];
+        current = 2 - current;
+        return m[current][0][0];
+    }, seconds));
+    report(name + " multiply", throughput([&]() {
+        multiply(m[current], m[1], m[2 - current]);
+        current = 2 - current;
+        return m[current][0][0];
+    }, seconds));
+}
+
+static void benchmarkMatrixProducts() {
+    std::cout << "==== matrix products ====" << std::endl;
+    
+    std::mt19937 rng(1);
+    benchmarkProduct<3>("3x3", rng);
+    benchmarkProduct<6>("6x6", rng);
+    benchmarkProduct<24>("24x24", rng);
+    benchmarkProduct<192>("192x192", rng, 1.0);
+    
+    // A set of 6x6 matrices all sent through the same transition, back and forth
+    // between two buffers. The transition is a rotation, so values stay bounded.
+    const int count = 1000;
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    mat66 transition = mat66::identity();
+    vec3 axis{uniform(rng), uniform(rng), uniform(rng)};
+    for(int i = 0; i < 3; ++i) {
+        vec3 column = vec3{i == 0 ? 1.0 : 0.0, i == 1 ? 1.0 : 0.0, i == 2 ? 1.0 : 0.0}.rotate(axis, 0.3);
+        for(int j = 0; j < 3; ++j) { transition[j][i] = transition[j+3][i+3] = column.data[j]; }
+    }
+    std::vector<mat66> buffers[2] = {std::vector<mat66>(count), std::vector<mat66>(count)};
+    for(auto& m : buffers[0]) { for(auto& row : m.data) { for(auto& e : row) { e = uniform(rng); } } }
+    
+    int current = 0;
+    report("1000 6x6, textbook loop", throughput([&]() {
+        for(int i = 0; i < count; ++i) { naiveProduct(transition, buffers[current][i], buffers[1 - current][i]); }
+        current = 1 - current;
+        return buffers[current][0][0][0];
+    }));
+    report("1000 6x6, one at a time", throughput([&]() {
+        for(int i = 0; i < count; ++i) { buffers[1 - current][i] = transition * buffers[current][i]; }
+        current = 1 - current;
+        return buffers[current][0][0][0];
+    }));
+    report("1000 6x6, batched", throughput([&]() {
+        multiply(transition, buffers[current].data(), buffers[1 - current].data(), count);
+        current = 1 - current;
+        return buffers[current][0][0][0];
+    }));
+    
+    // The covariance update of a linearised propagation, P = Φ P Φᵀ, fed back into itself.
+    mat66 covariance = buffers[0][0] * buffers[0][0].transpose(), mapped;
+    const mat66 transposed = transition.transpose();
+    report("covariance update, textbook loop", throughput([&]() {
+        naiveProduct(transition, covariance, mapped);
+        naiveProduct(mapped, transposed, covariance);
+        return covariance[0][0];
+    }));
+    report("covariance update, operator*", throughput([&]() {
+        covariance = transition * covariance * transposed;
+        return covariance[0][0];
+    }));
+    report("covariance update, multiply", throughput([&]() {
+        multiply(transition, covariance, mapped);
+        multiply(mapped, transposed, covariance);
+        return covariance[0][0];
+    }));
+    std::cout << std::endl;
+}
+
+static void benchmarkTimekeeping() {
+    std::cout << "==== timekeeping (30 days of variable steps) ====" << std::endl;
+    
+    // Random steps between 0.05s and 2s, as an adaptive integrator would take. They
+    // are whole multiples of 2^-40s, so their exact total can be kept as an integer.
+    const double unit = std::ldexp(1.0, -40);
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<std::int64_t> ticks(std::int64_t(0.05 / unit), std::int64_t(2 / unit));
+    std::vector<double> steps;
+    std::int64_t total = 0;
+    while(total * unit < 30 * 86400.0) {
+        auto step = ticks(rng);
+        total += step;
+        steps.push_back(step * unit);
+    }
+    const Epoch exact(total >> 40, (total & ((std::int64_t(1) << 40) - 1)) * unit);
+    
+    double naive = 0;
+    Clock clock;
+    for(double dt : steps) {
+        naive += dt;
+        clock.advance(dt);
+    }
+    const double day = 86164.0;
+    std::cout << steps.size() << " steps; t += dt error: " << std::abs(naive - exact.value())
+              << "s, Clock error: " << std::abs(clock.now() - exact) << "s" << std::endl;
+    std::cout << "rotation phase error, t += dt: " << std::abs(naive / day - exact.value() / day) * day
+              << "s, Clock: " << std::abs(clock.now().phase(day) - exact.phase(day)) * day << "s" << std::endl;
+    
+    double t = 0;
+    int i = 0;
+    report("t += dt", throughput([&]() { t += steps[i++ & 1023]; return t; }));
+    report("Clock::advance", throughput([&]() { clock.advance(steps[i++ & 1023]); return clock.now().fraction; }));
+    std::cout << std::endl;
+}
+
+int runBenchmarks() {
+    benchmarkHarmonics();
+    benchmarkGravityGrid();
+    benchmarkThirdBody();
+    benchmarkSolarRadiation();
+    benchmarkPatchedConics();
+    benchmarkNBody();
+    benchmarkForceModels();
+    benchmarkMultiRate();
+    benchmarkAscent();
+    benchmarkAscentOptimizer();
+    benchmarkSensitivities();
+    benchmarkTransitionMatrix();
+    benchmarkUncertainty();
+    benchmarkExtendedPrecision();
+    benchmarkExpressions();
+    benchmarkVectors();
+    benchmarkDecompositions();
+    benchmarkMatrixProducts();
+    benchmarkRotations();
+    benchmarkTimekeeping();
+    return 0;
+}
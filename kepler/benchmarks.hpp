@@ -0,0 +1,12 @@
+//
+//  benchmarks.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+
+/// Runs the performance benchmarks (`kepler --bench`) and prints the results.
+int runBenchmarks();
@@ -0,0 +1,353 @@
+//
+//  ddouble.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <cmath>
+#include <iostream>
+#include "vec.hpp"
+
+#if defined(__FAST_MATH__)
+#error "ddouble relies on exact IEEE rounding, which -ffast-math does not keep"
+#endif
+
+/*!
+ * @class       ddouble
+ * @ingroup     Geometry
+ * @brief       A double-double number: an unevaluated sum `hi + lo` of two doubles,
+ *              with `|lo| <= ulp(hi)/2`, for about 106 bits of precision.
+ * @details     Used as the component type of `vec` (and through it of `BasicState`,
+ *              and so of the force pipeline and `RK4::integrate`), it turns any generic
+ *              computation into a reference one, whose rounding errors are some
+ *              10^-16 times smaller than in doubles, at ten to twenty times the cost
+ *              rather than the hundreds an arbitrary-precision library would take.
+ *
+ *              Every operation is a fixed, branch-free sequence of double operations
+ *              (error-free transformations), which compilers schedule and vectorise
+ *              like any other arithmetic. Products use fused multiply-adds when the
+ *              target has them, and Dekker's splitting otherwise.
+ */
+struct ddouble {
+
+    /**
+     * @name        Creating Double-Double Numbers
+     * @{
+     */
+
+    ddouble() = default;
+
+    /*!
+     * @brief       Creates the double-double equal to a double.
+     */
+    constexpr ddouble(double value) : hi(value), lo(0) { }
+
+    /*!
+     * @brief       Creates a double-double from its two parts, which must not overlap.
+     */
+    constexpr ddouble(double hi, double lo) : hi(hi), lo(lo) { }
+
+    /**
+     * @}
+     */
+
+    /*!
+     * @brief       Conversion to the nearest double.
+     */
+    explicit operator double() const { return hi; }
+
+    double  hi;
+    double  lo;
+};
+
+static_assert(std::is_trivially_copyable<ddouble>::value, "double-doubles must stay trivially copyable");
+
+/*!
+ * @brief       Returns the plain value of a double-double, rounded to a double.
+ */
+inline double
+valueOf(const ddouble& x) { return x.hi; }
+
+// MARK: -
+// MARK: Error-free transformations
+
+/*!
+ * @internal
+ * @brief       `a + b` as a double-double, exactly (Knuth's two-sum).
+ */
+inline ddouble
+twoSum(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    return ddouble(s, (a - (s - bb)) + (b - bb));
+}
+
+/*!
+ * @internal
+ * @brief       `a + b` as a double-double, exactly, when `|a| >= |b|`.
+ */
+inline ddouble
+quickTwoSum(double a, double b) {
+    double s = a + b;
+    return ddouble(s, b - (s - a));
+}
+
+/*!
+ * @internal
+ * @brief       `a * b` as a double-double, exactly.
+ */
+inline ddouble
+twoProduct(double a, double b) {
+    double p = a * b;
+#if defined(__FMA__) || defined(FP_FAST_FMA)
+    return ddouble(p, std::fma(a, b, -p));
+#else
+    // Dekker: each factor is split in two halves of 26 bits, whose products are exact.
+    const double split = 134217729.0; // 2^27 + 1
+    double ta = split * a, tb = split * b;
+    double ah = ta - (ta - a), bh = tb - (tb - b);
+    double al = a - ah, bl = b - bh;
+    return ddouble(p, ((ah * bh - p) + ah * bl + al * bh) + al * bl);
+#endif
+}
+
+// MARK: -
+// MARK: Arithmetic
+
+inline ddouble
+operator+(const ddouble& a, const ddouble& b) {
+    // Both parts are summed exactly, so that values of opposite signs that cancel
+    // keep their full precision.
+    ddouble s = twoSum(a.hi, b.hi);
+    ddouble t = twoSum(a.lo, b.lo);
+    s = quickTwoSum(s.hi, s.lo + t.hi);
+    return quickTwoSum(s.hi, s.lo + t.lo);
+}
+
+inline ddouble
+operator+(const ddouble& a, double b) {
+    ddouble s = twoSum(a.hi, b);
+    return quickTwoSum(s.hi, s.lo + a.lo);
+}
+
+inline ddouble
+operator+(double a, const ddouble& b) { return b + a; }
+
+inline ddouble
+operator-(const ddouble& a) { return ddouble(-a.hi, -a.lo); }
+
+inline ddouble
+operator-(const ddouble& a, const ddouble& b) { return a + -b; }
+
+inline ddouble
+operator-(const ddouble& a, double b) { return a + -b; }
+
+inline ddouble
+operator-(double a, const ddouble& b) { return -b + a; }
+
+inline ddouble
+operator*(const ddouble& a, const ddouble& b) {
+    ddouble p = twoProduct(a.hi, b.hi);
+    return quickTwoSum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+inline ddouble
+operator*(const ddouble& a, double b) {
+    ddouble p = twoProduct(a.hi, b);
+    return quickTwoSum(p.hi, p.lo + a.lo * b);
+}
+
+inline ddouble
+operator*(double a, const ddouble& b) { return b * a; }
+
+inline ddouble
+operator/(const ddouble& a, const ddouble& b) {
+    // Long division: each quotient digit is a double, and the remainders are exact.
+    double q1 = a.hi / b.hi;
+    ddouble r = a - b * q1;
+    double q2 = r.hi / b.hi;
+    r = r - b * q2;
+    double q3 = r.hi / b.hi;
+    return quickTwoSum(q1, q2) + q3;
+}
+
+inline ddouble
+operator/(const ddouble& a, double b) {
+    // The divisor is exact, so one correction digit is enough.
+    double q1 = a.hi / b;
+    ddouble p = twoProduct(q1, b);
+    ddouble r = twoSum(a.hi, -p.hi);
+    double q2 = (r.hi + (r.lo + (a.lo - p.lo))) / b;
+    return quickTwoSum(q1, q2);
+}
+
+inline ddouble
+operator/(double a, const ddouble& b) { return ddouble(a) / b; }
+
+template <typename S> ddouble&
+operator+=(ddouble& a, const S& b) { return a = a + b; }
+
+template <typename S> ddouble&
+operator-=(ddouble& a, const S& b) { return a = a - b; }
+
+template <typename S> ddouble&
+operator*=(ddouble& a, const S& b) { return a = a * b; }
+
+template <typename S> ddouble&
+operator/=(ddouble& a, const S& b) { return a = a / b; }
+
+// MARK: -
+// MARK: Comparisons
+
+inline bool operator==(const ddouble& a, const ddouble& b) { return a.hi == b.hi && a.lo == b.lo; }
+inline bool operator!=(const ddouble& a, const ddouble& b) { return !(a == b); }
+inline bool operator<(const ddouble& a, const ddouble& b) { return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo); }
+inline bool operator>(const ddouble& a, const ddouble& b) { return b < a; }
+inline bool operator<=(const ddouble& a, const ddouble& b) { return !(b < a); }
+inline bool operator>=(const ddouble& a, const ddouble& b) { return !(a < b); }
+
+inline bool operator==(const ddouble& a, double b) { return a == ddouble(b); }
+inline bool operator!=(const ddouble& a, double b) { return a != ddouble(b); }
+inline bool operator<(const ddouble& a, double b) { return a < ddouble(b); }
+inline bool operator>(const ddouble& a, double b) { return a > ddouble(b); }
+inline bool operator<=(const ddouble& a, double b) { return a <= ddouble(b); }
+inline bool operator>=(const ddouble& a, double b) { return a >= ddouble(b); }
+
+// MARK: -
+// MARK: Math functions
+
+inline ddouble
+abs(const ddouble& a) { return a.hi < 0 ? -a : a; }
+
+inline ddouble
+sqrt(const ddouble& a) {
+    if(a.hi <= 0) { return ddouble(std::sqrt(a.hi)); }
+    // One Newton step from the double root: x + (a - x²) / 2x.
+    double x = std::sqrt(a.hi);
+    ddouble r = a - twoProduct(x, x);
+    return quickTwoSum(x, r.hi * (0.5 / x));
+}
+
+/*!
+ * @internal
+ * @brief       `ln(2)`, and `ln(2)/64`, to double-double precision.
+ */
+static const ddouble ddoubleLn2(6.931471805599452862e-01, 2.319046813846299558e-17);
+static const ddouble ddoubleLn2Over64(ddoubleLn2.hi / 64, ddoubleLn2.lo / 64);
+
+/*!
+ * @internal
+ * @brief       `2^(j/64)` for `j` in [0, 64), summed once from the full series.
+ */
+inline const ddouble*
+ddoubleExp2Table() {
+    static const struct Table {
+        Table() {
+            for(int j = 0; j < 64; ++j) {
+                ddouble x = ddoubleLn2Over64 * double(j), term = 1.0, sum = 1.0;
+                for(int n = 1; n < 40 && term.hi != 0; ++n) {
+                    term = term * x / double(n);
+                    sum = sum + term;
+                }
+                values[j] = sum;
+            }
+        }
+        ddouble values[64];
+    } table;
+    return table.values;
+}
+
+inline ddouble
+exp(const ddouble& a) {
+    if(a.hi > 709.8) { return ddouble(INFINITY); }
+    if(a.hi < -745.2) { return ddouble(0.0); }
+
+    // exp(a) = 2^k · 2^(j/64) · exp(r), with |r| <= ln2/128: the first factor is exact,
+    // the second comes from a table, and twelve terms of the series give the third.
+    // Terms past r⁶ are below 10^-19, so they only need to be summed in doubles.
+    static const ddouble inverseFactorials[] = {
+        ddouble(1.0 / 2.0),
+        ddouble(1.6666666666666666e-01, 9.2518585385429707e-18),
+        ddouble(4.1666666666666664e-02, 2.3129646346357427e-18),
+        ddouble(8.3333333333333332e-03, 1.1564823173178714e-19),
+        ddouble(1.3888888888888889e-03, -5.3005439543735771e-20),
+        ddouble(1.9841269841269841e-04, 1.7209558293420705e-22),
+        ddouble(2.4801587301587302e-05, 2.1511947866775882e-23),
+        ddouble(2.7557319223985893e-06, -1.8583932740464721e-22),
+        ddouble(2.7557319223985888e-07, 2.3767714622250297e-23),
+        ddouble(2.5052108385441720e-08, -1.4488140709359120e-24),
+    };
+    double m = std::nearbyint(a.hi / ddoubleLn2Over64.hi);
+    double k = std::floor(m / 64);
+    ddouble r = a - ddoubleLn2Over64 * m;
+    double tail = inverseFactorials[9].hi;
+    for(int n = 8; n >= 5; --n) {
+        tail = tail * r.hi + inverseFactorials[n].hi;
+    }
+    ddouble sum = tail;
+    for(int n = 4; n >= 0; --n) {
+        sum = sum * r + inverseFactorials[n];
+    }
+    sum = (sum * r + 1.0) * r + 1.0;
+    sum = sum * ddoubleExp2Table()[int(m - 64 * k)];
+    return ddouble(std::ldexp(sum.hi, int(k)), std::ldexp(sum.lo, int(k)));
+}
+
+inline std::ostream&
+operator<<(std::ostream& s, const ddouble& d) {
+    return s << d.hi << (d.lo < 0 ? " - " : " + ") << std::abs(d.lo);
+}
+
+// MARK: -
+// MARK: Vectors of double-doubles
+
+// vec * ddouble
+template <int S> const vec<ddouble, S>
+operator*(const vec<ddouble, S>& lhs, const ddouble& rhs) {
+    vec<ddouble, S> v(lhs);
+    for(int i = 0; i < S; ++i) {
+        v.data[i] = v.data[i] * rhs;
+    }
+    return v;
+}
+
+// ddouble * vec
+template <int S> const vec<ddouble, S>
+operator*(const ddouble& lhs, const vec<ddouble, S>& rhs) {
+    return rhs * lhs;
+}
+
+// vec / ddouble
+template <int S> const vec<ddouble, S>
+operator/(const vec<ddouble, S>& lhs, const ddouble& rhs) {
+    return lhs * (1.0 / rhs);
+}
+
+/*!
+ * @brief       Returns the components of a vector of double-doubles, rounded to doubles.
+ */
+template <int S> vec<double, S>
+valueOf(const vec<ddouble, S>& v) {
+    vec<double, S> r;
+    for(int i = 0; i < S; ++i) {
+        r.data[i] = v.data[i].hi;
+    }
+    return r;
+}
+
+/*!
+ * @brief       Evaluates a function of a position in doubles at the rounded value of
+ *              `at`: models that only exist in doubles stay in doubles.
+ */
+template <typename F> ddouble
+constantOf(const vec<ddouble, 3>& at, const F& f) { return ddouble(f(valueOf(at))); }
+
+template <typename F> vec<ddouble, 3>
+constantVectorOf(const vec<ddouble, 3>& at, const F& f) {
+    auto v = f(valueOf(at));
+    return vec<ddouble, 3>(v.x, v.y, v.z);
+}
+
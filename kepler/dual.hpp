@@ -0,0 +1,323 @@
+//
+//  dual.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <cmath>
+#include <iostream>
+#include "vec.hpp"
+
+/*!
+ * @class       dual
+ * @ingroup     Geometry
+ * @brief       A dual number, for forward-mode automatic differentiation.
+ * @details     Carries a value and its partial derivatives with respect to `N`
+ *              independent variables. Arithmetic and the usual math functions apply
+ *              the chain rule as they go, so any computation written for a generic
+ *              scalar type yields its exact derivatives in the same pass. Duals are
+ *              trivially copyable and can be used as the component type of `vec`.
+ * @tparam      N               The number of independent variables.
+ */
+template <int N>
+struct dual {
+
+    /**
+     * @name        Creating Dual Numbers
+     * @{
+     */
+
+    dual() = default;
+
+    /*!
+     * @brief       Creates a constant: its derivatives are all zero.
+     * @param       value       Value of the constant.
+     */
+    dual(double value) : value(value) {
+        unrolled<0, N>::apply([&](int i) { grad[i] = 0; });
+    }
+
+    /*!
+     * @brief       Creates the independent variable `index`.
+     * @param       value       Value of the variable.
+     * @param       index       Which of the `N` variables this is.
+     * @return      A dual number whose derivative is 1 along `index`, 0 elsewhere.
+     */
+    static dual
+    variable(double value, int index) {
+        dual d(value);
+        d.grad[index] = 1;
+        return d;
+    }
+
+    /**
+     * @}
+     */
+
+    /*!
+     * @brief       Conversion to the plain value, dropping the derivatives.
+     */
+    explicit operator double() const { return value; }
+
+    double  value;
+    double  grad[N];
+};
+
+/*!
+ * @brief       Returns the plain value of a scalar, whether it is a dual number or not.
+ */
+inline double
+valueOf(double x) { return x; }
+
+template <int N> double
+valueOf(const dual<N>& x) { return x.value; }
+
+// MARK: -
+// MARK: Arithmetic
+
+template <int N> dual<N>
+operator+(const dual<N>& a, const dual<N>& b) {
+    dual<N> r;
+    r.value = a.value + b.value;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = a.grad[i] + b.grad[i]; });
+    return r;
+}
+
+template <int N> dual<N>
+operator-(const dual<N>& a, const dual<N>& b) {
+    dual<N> r;
+    r.value = a.value - b.value;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = a.grad[i] - b.grad[i]; });
+    return r;
+}
+
+template <int N> dual<N>
+operator*(const dual<N>& a, const dual<N>& b) {
+    dual<N> r;
+    r.value = a.value * b.value;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = a.grad[i] * b.value + a.value * b.grad[i]; });
+    return r;
+}
+
+template <int N> dual<N>
+operator/(const dual<N>& a, const dual<N>& b) {
+    double inverse = 1 / b.value;
+    dual<N> r;
+    r.value = a.value * inverse;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = (a.grad[i] - r.value * b.grad[i]) * inverse; });
+    return r;
+}
+
+template <int N> dual<N>
+operator-(const dual<N>& a) {
+    dual<N> r;
+    r.value = -a.value;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = -a.grad[i]; });
+    return r;
+}
+
+// Mixed operations with plain numbers skip the multiplications by zero.
+
+template <int N> dual<N>
+operator+(const dual<N>& a, double b) {
+    dual<N> r = a;
+    r.value += b;
+    return r;
+}
+
+template <int N> dual<N>
+operator+(double a, const dual<N>& b) { return b + a; }
+
+template <int N> dual<N>
+operator-(const dual<N>& a, double b) { return a + (-b); }
+
+template <int N> dual<N>
+operator-(double a, const dual<N>& b) { return -b + a; }
+
+template <int N> dual<N>
+operator*(const dual<N>& a, double b) {
+    dual<N> r;
+    r.value = a.value * b;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = a.grad[i] * b; });
+    return r;
+}
+
+template <int N> dual<N>
+operator*(double a, const dual<N>& b) { return b * a; }
+
+template <int N> dual<N>
+operator/(const dual<N>& a, double b) { return a * (1 / b); }
+
+template <int N> dual<N>
+operator/(double a, const dual<N>& b) {
+    double inverse = 1 / b.value;
+    dual<N> r;
+    r.value = a * inverse;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = -r.value * b.grad[i] * inverse; });
+    return r;
+}
+
+template <int N, typename S> dual<N>&
+operator+=(dual<N>& a, const S& b) { return a = a + b; }
+
+template <int N, typename S> dual<N>&
+operator-=(dual<N>& a, const S& b) { return a = a - b; }
+
+template <int N, typename S> dual<N>&
+operator*=(dual<N>& a, const S& b) { return a = a * b; }
+
+template <int N, typename S> dual<N>&
+operator/=(dual<N>& a, const S& b) { return a = a / b; }
+
+// MARK: -
+// MARK: Comparisons (on values only)
+
+template <int N> bool operator==(const dual<N>& a, const dual<N>& b) { return a.value == b.value; }
+template <int N> bool operator!=(const dual<N>& a, const dual<N>& b) { return a.value != b.value; }
+template <int N> bool operator<(const dual<N>& a, const dual<N>& b) { return a.value < b.value; }
+template <int N> bool operator>(const dual<N>& a, const dual<N>& b) { return a.value > b.value; }
+template <int N> bool operator<=(const dual<N>& a, const dual<N>& b) { return a.value <= b.value; }
+template <int N> bool operator>=(const dual<N>& a, const dual<N>& b) { return a.value >= b.value; }
+
+template <int N> bool operator==(const dual<N>& a, double b) { return a.value == b; }
+template <int N> bool operator!=(const dual<N>& a, double b) { return a.value != b; }
+template <int N> bool operator<(const dual<N>& a, double b) { return a.value < b; }
+template <int N> bool operator>(const dual<N>& a, double b) { return a.value > b; }
+template <int N> bool operator<=(const dual<N>& a, double b) { return a.value <= b; }
+template <int N> bool operator>=(const dual<N>& a, double b) { return a.value >= b; }
+
+// MARK: -
+// MARK: Math functions
+
+/*!
+ * @internal
+ * @brief       Applies the chain rule for a function with value `f` and derivative `df` at `a`.
+ */
+template <int N> dual<N>
+chain(const dual<N>& a, double f, double df) {
+    dual<N> r;
+    r.value = f;
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = df * a.grad[i]; });
+    return r;
+}
+
+template <int N> dual<N>
+sqrt(const dual<N>& a) {
+    double s = std::sqrt(a.value);
+    return chain(a, s, 0.5 / s);
+}
+
+template <int N> dual<N>
+exp(const dual<N>& a) {
+    double e = std::exp(a.value);
+    return chain(a, e, e);
+}
+
+template <int N> dual<N>
+log(const dual<N>& a) { return chain(a, std::log(a.value), 1 / a.value); }
+
+template <int N> dual<N>
+sin(const dual<N>& a) { return chain(a, std::sin(a.value), std::cos(a.value)); }
+
+template <int N> dual<N>
+cos(const dual<N>& a) { return chain(a, std::cos(a.value), -std::sin(a.value)); }
+
+template <int N> dual<N>
+asin(const dual<N>& a) { return chain(a, std::asin(a.value), 1 / std::sqrt(1 - a.value * a.value)); }
+
+template <int N> dual<N>
+acos(const dual<N>& a) { return chain(a, std::acos(a.value), -1 / std::sqrt(1 - a.value * a.value)); }
+
+template <int N> dual<N>
+atan2(const dual<N>& y, const dual<N>& x) {
+    double r2 = x.value * x.value + y.value * y.value;
+    dual<N> r;
+    r.value = std::atan2(y.value, x.value);
+    unrolled<0, N>::apply([&](int i) { r.grad[i] = (x.value * y.grad[i] - y.value * x.grad[i]) / r2; });
+    return r;
+}
+
+template <int N> dual<N>
+pow(const dual<N>& a, double p) {
+    double f = std::pow(a.value, p);
+    return chain(a, f, p * f / a.value);
+}
+
+template <int N> dual<N>
+abs(const dual<N>& a) { return a.value < 0 ? -a : a; }
+
+template <int N> std::ostream&
+operator<<(std::ostream& s, const dual<N>& d) {
+    s << d.value << " [";
+    for(int i = 0; i < N; ++i) { s << (i ? ", " : "") << d.grad[i]; }
+    return s << "]";
+}
+
+// MARK: -
+// MARK: Vectors of dual numbers
+
+// vec * dual
+template <int N, int S> const vec<dual<N>, S>
+operator*(const vec<dual<N>, S>& lhs, const dual<N>& rhs) {
+    vec<dual<N>, S> v(lhs);
+    for(int i = 0; i < S; ++i) {
+        v.data[i] = v.data[i] * rhs;
+    }
+    return v;
+}
+
+// dual * vec
+template <int N, int S> const vec<dual<N>, S>
+operator*(const dual<N>& lhs, const vec<dual<N>, S>& rhs) {
+    return rhs * lhs;
+}
+
+// vec / dual
+template <int N, int S> const vec<dual<N>, S>
+operator/(const vec<dual<N>, S>& lhs, const dual<N>& rhs) {
+    return lhs * (1.0 / rhs);
+}
+
+/*!
+ * @brief       Returns the plain values of a vector, whether it holds dual numbers or not.
+ */
+template <int S> vec<double, S>
+valueOf(const vec<double, S>& v) { return v; }
+
+template <int N, int S> vec<double, S>
+valueOf(const vec<dual<N>, S>& v) {
+    vec<double, S> r;
+    for(int i = 0; i < S; ++i) {
+        r.data[i] = v.data[i].value;
+    }
+    return r;
+}
+
+/*!
+ * @brief       Evaluates `f`, a function of a position in doubles, at `at`, for any
+ *              scalar type: the result is a constant, without derivatives. Used for
+ *              the few models that only exist in doubles (the non-spherical field,
+ *              the shadow geometry), whose derivatives are negligible next to the
+ *              central terms'.
+ */
+template <typename F> double
+constantOf(const vec<double, 3>& at, const F& f) { return f(at); }
+
+template <int N, typename F> dual<N>
+constantOf(const vec<dual<N>, 3>& at, const F& f) { return dual<N>(f(valueOf(at))); }
+
+/*!
+ * @brief       The vector counterpart of `constantOf`.
+ */
+template <typename F> vec<double, 3>
+constantVectorOf(const vec<double, 3>& at, const F& f) { return f(at); }
+
+template <int N, typename F> vec<dual<N>, 3>
+constantVectorOf(const vec<dual<N>, 3>& at, const F& f) {
+    auto v = f(valueOf(at));
+    return vec<dual<N>, 3>(v.x, v.y, v.z);
+}
+
@@ -9,9 +9,11 @@
 #include <iostream>
 #include <fstream>
 #include <cstdint>
+#include <string>
 #include "RK4.hpp"
 #include "MassiveBody.hpp"
 #include "Orbit.hpp"
+#include "benchmarks.hpp"
 
 struct Body : SolidBody {
     
@@ -19,15 +21,17 @@ struct Body : SolidBody {
     double  _mass;
     double  _area;
     double  _cd;
+    double  _cr;
     vec3    _forces;
     
-    Body(double mass, double area, double cd) : _mass(mass), _area(area), _cd(cd) {}
+    Body(double mass, double area, double cd, double cr = 1.3) : _mass(mass), _area(area), _cd(cd), _cr(cr) {}
     
     virtual State stateVectors() const { return _state; }
     virtual double mass() const { return _mass; }
     virtual vec3 forces() const { return _forces; }
     virtual double dragCoefficient() const { return _cd; }
     virtual double surfaceArea() const { return _area; }
+    virtual double reflectivity() const { return _cr; }
     
     
 };
@@ -42,13 +46,17 @@ void debug_orbit(const Orbit& o, const MassiveBody& p) {
     std::cout << std::endl;
 }
 
-const MassiveBody::coordinates boca_chica{25.996, -97.154, 160.0e3};
-const MassiveBody::coordinates ccafs{28.562106, -80.577180, 10000.0e3};
-const MassiveBody::coordinates gto{0.0, 0.0, 80.0e3};
-const MassiveBody::coordinates sso{25.996, -97.154, 200.0e3};
+constexpr MassiveBody::coordinates boca_chica{25.996, -97.154, 160.0e3};
+constexpr MassiveBody::coordinates ccafs{28.562106, -80.577180, 10000.0e3};
+constexpr MassiveBody::coordinates gto{0.0, 0.0, 80.0e3};
+constexpr MassiveBody::coordinates sso{25.996, -97.154, 200.0e3};
 
 int main(int argc, const char * argv[]) {
     
+    if(argc > 1 && std::string(argv[1]) == "--bench") {
+        return runBenchmarks();
+    }
+    
     auto earth = MassiveBody("Earth", 3600*24, 6371e3, 3.986004418e14, 1.221, 8.5e3, 2000e3);
     auto kerbin = MassiveBody("Kerbin", 3600*9, 1200e3, 14126.4e9, 1.221, 5.6e3, 70e3);
     
@@ -77,29 +85,30 @@ int main(int argc, const char * argv[]) {
     std::ofstream out{argv[1]};
     out << "time,x,y,z,ix,iy,iz,lat,lon,alt" << std::endl;
     
-    double time = 0;
+    Clock clock;
     double inc = .10;
     double simu_time = 6;
     
     for(uint64_t i = 0; i < (simu_time/inc)*3600; ++i) {
-        time += i*inc;
-        body._state = integrator.advanceState(body, earth, inc);
+        body._state = integrator.advanceState(body, earth, clock.now().value(), inc);
+        clock.advance(inc);
         
         if(body._state.p.magnitude() < earth.radius()+50e3) break;
         
         if(i % 40 != 0) continue;
         
-        auto coord = earth.polar(body._state.p, i*inc);
+        auto coord = earth.polar(body._state.p, clock.now());
         //coord.altitude = 0;
         auto inertial = earth.cartesian(coord);
         
-        out << time << ",";
+        out << clock.now() << ",";
         out << body._state.p.x << "," << body._state.p.y << "," << body._state.p.z << ",";
         out << inertial.x << "," << inertial.y << ","  << inertial.z << ",";
         out << coord.latitude << "," << coord.longitude << "," << coord.altitude << std::endl;
         
     }
     
+    double time = clock.elapsed();
     std::cout << "simulation ended after " << std::floor(time) << "seconds (" << std::floor(time/3600.0) << " h, " << std::floor(time/(24 * 3600.0)) << "d)" << std::endl;
     
     debug_orbit(Orbit(earth, body._state.p, body._state.v), earth);
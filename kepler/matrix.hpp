@@ -8,8 +8,25 @@
 
 #pragma once
 
+#include <cmath>
 #include <iostream>
 #include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "utils.hpp"
+#if KEPLER_SIMD
+#include <immintrin.h>
+#endif
+
+template <int n> struct LU;
+
+/*!
+ * @internal
+ * @brief       Selects the matrix constructor that leaves the components uninitialised,
+ *              for products that write every one of them before reading any.
+ */
+struct uninitialized {};
 
 /*!
  * @class       Mat
@@ -33,23 +50,31 @@ struct matrix {
      * @brief       Creates a new matrix whose components are initialized to a single value.
      * @param       value       Value to set the matrix's components to.
      */
-    matrix(double value = 0) {
+    constexpr matrix(double value = 0) : data{} {
         for(int i = 0; i < rows; ++i) {
-            std::fill_n(data[i], cols, value);
+            for(int j = 0; j < cols; ++j) {
+                data[i][j] = value;
+            }
         }
     }
     
+    /*!
+     * @internal
+     * @brief       Creates a matrix whose components are left uninitialised.
+     */
+    explicit matrix(uninitialized) {}
+    
     /*!
      * @brief       Creates a matrix from a list of values.
      * @note        Values should be ordered by column, and then by line.
      * @param       values      Braced list of values to build the matrix from.
      */
-    matrix(std::initializer_list<double> values) {
+    constexpr matrix(std::initializer_list<double> values) : data{} {
         if(values.size() != rows*cols) {
             throw std::runtime_error("Wrong number of matrix components");
         }
         int i = 0;
-        for(float v : values) {
+        for(double v : values) {
             data[i/cols][i%cols] = v;
             ++i;
         }
@@ -67,7 +92,7 @@ struct matrix {
      @endverbatim
      * @return      The identity matrix.
      */
-    static matrix
+    static constexpr matrix
     identity() {
         matrix m;
         for(int i = 0; i < rows; ++i) {
@@ -78,16 +103,16 @@ struct matrix {
         return m;
     }
     
-    static matrix
+    static constexpr matrix
     null() {
-        return matrix{NAN};
+        return matrix(NAN);
     }
     
     /*!
      * @brief       Returns the Transpose of the matrix.
      * @return      The transpose of the matrix.
      */
-    matrix<cols, rows>
+    constexpr matrix<cols, rows>
     transpose() const {
         matrix<cols, rows> m;
         for(int i = 0; i < rows; ++i) {
@@ -98,9 +123,23 @@ struct matrix {
         return m;
     }
     
+    /*!
+     * @brief       Returns the determinant of a square matrix, from its LU decomposition.
+     */
     double
     determinant() const {
-        return 0;
+        static_assert(rows == cols, "Only square matrices have a determinant");
+        return LU<rows>(*this).determinant();
+    }
+    
+    /*!
+     * @brief       Returns the inverse of a square matrix, from its LU decomposition.
+     * @throws      std::runtime_error if the matrix is singular.
+     */
+    matrix
+    inverse() const {
+        static_assert(rows == cols, "Only square matrices have an inverse");
+        return LU<rows>(*this).inverse();
     }
     
     /**
@@ -114,7 +153,7 @@ struct matrix {
      * @return      Pointer to the row's first index. Will be invalidated if the matrix is
      *              deleted from memory.
      */
-    double*
+    constexpr double*
     operator[] (int row) {
         return data[row];
     }
@@ -126,7 +165,7 @@ struct matrix {
      * @return      Pointer to the row's first index. Will be invalidated if the matrix is
      *              deleted from memory.
      */
-    const double* const
+    constexpr const double*
     operator[] (int row) const {
         return data[row];
     }
@@ -159,7 +198,7 @@ struct matrix {
  * @internal
  * @brief       Add a matrix to <code>this</code>
  */
-template<int r, int c> matrix<r,c>&
+template<int r, int c> constexpr matrix<r,c>&
 operator+=(matrix<r,c>& lhs, const matrix<r,c>& rhs) {
     for(int i = 0; i < r; ++i) {
         for(int j = 0; j < c; ++j) {
@@ -173,7 +212,7 @@ operator+=(matrix<r,c>& lhs, const matrix<r,c>& rhs) {
  * @internal
  * @brief       Subtract a matrix from <code>this</code>
  */
-template<int r, int c> matrix<r,c>&
+template<int r, int c> constexpr matrix<r,c>&
 operator-=(matrix<r,c>& lhs, const matrix<r,c>& rhs) {
     for(int i = 0; i < r; ++i) {
         for(int j = 0; j < c; ++j) {
@@ -189,7 +228,7 @@ operator-=(matrix<r,c>& lhs, const matrix<r,c>& rhs) {
  * @internal
  * @brief       Multiply <code>this</code> by a scalar.
  */
-template<int r, int c> matrix<r,c>&
+template<int r, int c> constexpr matrix<r,c>&
 operator*=(matrix<r,c>& lhs, double scalar) {
     for(int i = 0; i < r; ++i) {
         for(int j = 0; j < c; ++j) {
@@ -203,7 +242,7 @@ operator*=(matrix<r,c>& lhs, double scalar) {
  * @internal
  * @brief       Divide <code>this</code> by a scalar.
  */
-template<int r, int c> matrix<r,c>&
+template<int r, int c> constexpr matrix<r,c>&
 operator/=(matrix<r,c>& lhs, double scalar) {
     for(int i = 0; i < r; ++i) {
         for(int j = 0; j < c; ++j) {
@@ -222,7 +261,7 @@ operator/=(matrix<r,c>& lhs, double scalar) {
  * @internal
  * @brief       Add two matrices together.
  */
-template<int r, int c> const matrix<r,c>
+template<int r, int c> constexpr const matrix<r,c>
 operator+(const matrix<r,c>& lhs, const matrix<r,c>& rhs) {
     matrix<r,c> m(lhs);
     return m += rhs;
@@ -231,31 +270,203 @@ operator+(const matrix<r,c>& lhs, const matrix<r,c>& rhs) {
 /*!
  * @brief       Subtract a matrix from another.
  */
-template<int r, int c> const matrix<r,c>
+template<int r, int c> constexpr const matrix<r,c>
 operator-(const matrix<r,c>& lhs, const matrix<r,c>& rhs) {
     matrix<r,c> m(lhs);
     return m -= rhs;
 }
 
+// MARK: Matrix products
+
+#if KEPLER_SIMD
+/*!
+ * @internal
+ * @brief       `y[0..n) += s·x[0..n)`: one row of a matrix product, two or four
+ *              columns at a time.
+ */
+inline void
+accumulateRow(double* y, double s, const double* x, int n) {
+    int j = 0;
+#if defined(__AVX__)
+    const __m256d s4 = _mm256_set1_pd(s);
+    for(; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(y + j, _mm256_add_pd(_mm256_loadu_pd(y + j), _mm256_mul_pd(s4, _mm256_loadu_pd(x + j))));
+    }
+#endif
+    const __m128d s2 = _mm_set1_pd(s);
+    for(; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(y + j, _mm_add_pd(_mm_loadu_pd(y + j), _mm_mul_pd(s2, _mm_loadu_pd(x + j))));
+    }
+    for(; j < n; ++j) {
+        y[j] += s * x[j];
+    }
+}
+
+/*!
+ * @internal
+ * @brief       Computes `p = lhs·rhs`, row by row: each row of `p` is accumulated from the
+ *              rows of `rhs`, which are contiguous and load into vector registers. Every
+ *              element still sums its terms in order of `k`, so the result is the same as
+ *              with the textbook dot-product loop. Small products (up to 8 columns and
+ *              inner terms) unroll each row and keep the row being accumulated in
+ *              registers.
+ */
+template <int a, int b, int c, bool small = (b <= 8 && c <= 8)>
+struct product {
+    static void
+    apply(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p) {
+        for(int i = 0; i < a; ++i) {
+            double row[c] = {};
+            iterate<b>::apply([&](auto k) { accumulateRow(row, lhs[i][k], rhs[k], c); });
+            iterate<c>::apply([&](auto j) { p[i][j] = row[j]; });
+        }
+    }
+};
+
+/*!
+ * @internal
+ * @brief       Larger products are blocked, so that the slice of `rhs` in use stays in
+ *              cache while every row of `lhs` goes over it. Blocks of `k` are taken in
+ *              order, which keeps the summation order of every element.
+ */
+template <int a, int b, int c>
+struct product<a, b, c, false> {
+    static const int block = 64;
+
+    static void
+    apply(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p) {
+        p = matrix<a, c>(0.0);
+        for(int kk = 0; kk < b; kk += block) {
+            const int kEnd = kk + block < b ? kk + block : b;
+            for(int jj = 0; jj < c; jj += block) {
+                const int width = jj + block < c ? block : c - jj;
+                for(int i = 0; i < a; ++i) {
+                    for(int k = kk; k < kEnd; ++k) {
+                        accumulateRow(p[i] + jj, lhs[i][k], rhs[k] + jj, width);
+                    }
+                }
+            }
+        }
+    }
+};
+#else
+/*!
+ * @internal
+ * @brief       Computes `p = lhs·rhs` in tiles of up to 4×4 elements, kept in registers
+ *              while `k` runs over the inner dimension: every element of `lhs` loaded
+ *              serves a whole row of the tile and every element of `rhs` a whole column,
+ *              where the textbook loop loads two operands per term. Every element still
+ *              sums its terms in order of `k`, so the result is the same as with the
+ *              textbook loop. Compilers vectorise the rows of a tile with plain SSE2.
+ */
+template <int a, int b, int c>
+struct product {
+    static void
+    apply(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p) {
+        int i = 0;
+        for(; i + 4 <= a; i += 4) { rows<4>(lhs, rhs, p, i); }
+        if(a - i >= 2) { rows<2>(lhs, rhs, p, i); i += 2; }
+        if(i < a) { rows<1>(lhs, rhs, p, i); }
+    }
+
+private:
+    template <int R>
+    static void
+    rows(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p, int i) {
+        int j = 0;
+        for(; j + 4 <= c; j += 4) { tile<R, 4>(lhs, rhs, p, i, j); }
+        if(c - j >= 2) { tile<R, 2>(lhs, rhs, p, i, j); j += 2; }
+        if(j < c) { tile<R, 1>(lhs, rhs, p, i, j); }
+    }
+
+    template <int R, int C>
+    static void
+    tile(const matrix<a, b>& lhs, const matrix<b, c>& rhs, matrix<a, c>& p, int i, int j) {
+        double sum[R][C] = {};
+        for(int k = 0; k < b; ++k) {
+            iterate<R>::apply([&](auto r) {
+                const double s = lhs[i + r][k];
+                iterate<C>::apply([&](auto q) { sum[r][q] += s * rhs[k][j + q]; });
+            });
+        }
+        iterate<R>::apply([&](auto r) { iterate<C>::apply([&](auto q) { p[i + r][j + q] = sum[r][q]; }); });
+    }
+};
+#endif
+
+/*!
+ * @internal
+ * @brief       `lhs·rhs`, written straight into the returned matrix: neither zero-filled
+ *              first nor copied out.
+ */
+template<int a, int b, int c> matrix<a, c>
+productOf(const matrix<a,b>& lhs, const matrix<b,c>& rhs) {
+    matrix<a,c> p{uninitialized()};
+    product<a, b, c>::apply(lhs, rhs, p);
+    return p;
+}
+
 /*!
  * @internal
  * @brief       Multiply a matrix by another.
  */
-template<int a, int b, int c> const matrix<a, c>
+template<int a, int b, int c> constexpr const matrix<a, c>
 operator*(const matrix<a,b>& lhs, const matrix<b,c>& rhs) {
-    //auto _rhs = rhs.transpose();
-    matrix<a,c> p = 0;
-    double temp;
-    for(int i = 0; i < a; ++i) {
-        for(int j = 0; j < c; ++j) {
-            temp = 0;
-            for(int k = 0; k < b; ++k) {
-                temp += lhs[i][k] * rhs[k][j];
+    if(constantEvaluated()) {
+        matrix<a,c> p = 0;
+        for(int i = 0; i < a; ++i) {
+            for(int j = 0; j < c; ++j) {
+                double temp = 0;
+                for(int k = 0; k < b; ++k) {
+                    temp += lhs[i][k] * rhs[k][j];
+                }
+                p[i][j] = temp;
             }
-            p[i][j] = temp;
         }
+        return p;
+    }
+    return productOf(lhs, rhs);
+}
+
+/*!
+ * @brief       Computes `out = lhs·rhs` in place, without the temporary `operator*` returns.
+ * @param       lhs         Left-hand matrix.
+ * @param       rhs         Right-hand matrix.
+ * @param       out         Where to write the product; must not overlap the inputs.
+ */
+template<int a, int b, int c> void
+multiply(const matrix<a,b>& lhs, const matrix<b,c>& rhs, matrix<a,c>& out) {
+    product<a, b, c>::apply(lhs, rhs, out);
+}
+
+/*!
+ * @brief       Multiplies many pairs of matrices: `out[i] = lhs[i]·rhs[i]`. Results are
+ *              written in place, which spares the copies of `operator*` when thousands of
+ *              small products (transition matrices, covariances) are needed per step.
+ * @param       lhs         Left-hand matrices.
+ * @param       rhs         Right-hand matrices.
+ * @param       out         Where to write the products; must not overlap the inputs.
+ * @param       count       Number of products.
+ */
+template<int a, int b, int c> void
+multiply(const matrix<a,b>* lhs, const matrix<b,c>* rhs, matrix<a,c>* out, int count) {
+    for(int i = 0; i < count; ++i) {
+        product<a, b, c>::apply(lhs[i], rhs[i], out[i]);
+    }
+}
+
+/*!
+ * @brief       Applies one matrix to many: `out[i] = lhs·rhs[i]`.
+ * @param       lhs         Left-hand matrix, shared by every product.
+ * @param       rhs         Right-hand matrices.
+ * @param       out         Where to write the products; must not overlap the inputs.
+ * @param       count       Number of products.
+ */
+template<int a, int b, int c> void
+multiply(const matrix<a,b>& lhs, const matrix<b,c>* rhs, matrix<a,c>* out, int count) {
+    for(int i = 0; i < count; ++i) {
+        product<a, b, c>::apply(lhs, rhs[i], out[i]);
     }
-    return p;
 }
 
 // MARK: Matrix-to-scalar ops
@@ -266,7 +477,7 @@ operator*(const matrix<a,b>& lhs, const matrix<b,c>& rhs) {
  * @internal
  * @brief       Multiply a matrix by a scalar.
  */
-template<int r, int c> const matrix<r,c>
+template<int r, int c> constexpr const matrix<r,c>
 operator*(const matrix<r,c>& lhs, double rhs) {
     matrix<r,c> m(lhs);
     return m *= rhs;
@@ -276,7 +487,7 @@ operator*(const matrix<r,c>& lhs, double rhs) {
  * @internal
  * @brief       Multiply a matrix by a scalar.
  */
-template<int r, int c> const matrix<r,c>
+template<int r, int c> constexpr const matrix<r,c>
 operator*(double lhs, const matrix<r,c>& rhs) {
     matrix<r,c> m(rhs);
     return m *= lhs;
@@ -285,12 +496,215 @@ operator*(double lhs, const matrix<r,c>& rhs) {
 /*!
  * @brief       Divide a matrix by a scalar.
  */
-template<int r, int c> const matrix<r,c>
+template<int r, int c> constexpr const matrix<r,c>
 operator/(const matrix<r,c>& lhs, double rhs) {
     matrix<r,c> m(lhs);
     return m /= rhs;
 }
 
+// MARK: -
+// MARK: Decompositions
+
+/*!
+ * @class       LU
+ * @ingroup     Geometry
+ * @brief       LU decomposition of a square matrix with partial pivoting: `P·A = L·U`.
+ * @details     Sizes are known at compile time, so small decompositions and solves are
+ *              fully unrolled (see `iterate`). A matrix with a zero column left after
+ *              pivoting is flagged as singular rather than rejected, so its determinant
+ *              can still be asked for; solving with it throws.
+ * @tparam      n               The size of the matrix.
+ */
+template <int n>
+struct LU {
+    
+    /*!
+     * @brief       Decomposes a matrix.
+     * @param       a           Matrix to decompose.
+     */
+    explicit LU(const matrix<n, n>& a) : factors(a), sign(1), singular(false) {
+        iterate<n>::apply([&](auto i) { permutation[i] = i; });
+        iterate<n>::apply([&](auto k) {
+            int pivot = k;
+            double largest = std::abs(factors[k][k]);
+            iterate<n>::apply([&](auto i) {
+                if(i > k && std::abs(factors[i][k]) > largest) {
+                    pivot = i;
+                    largest = std::abs(factors[i][k]);
+                }
+            });
+            if(largest == 0) {
+                singular = true;
+                return;
+            }
+            if(pivot != k) {
+                iterate<n>::apply([&](auto j) { std::swap(factors[k][j], factors[pivot][j]); });
+                std::swap(permutation[k], permutation[pivot]);
+                sign = -sign;
+            }
+            iterate<n>::apply([&](auto i) {
+                if(i <= k) { return; }
+                double f = factors[i][k] /= factors[k][k];
+                iterate<n>::apply([&](auto j) { if(j > k) { factors[i][j] -= f * factors[k][j]; } });
+            });
+        });
+    }
+    
+    /*!
+     * @brief       Solves `A·x = b` for a vector `b` (anything indexable with `[]`).
+     * @throws      std::runtime_error if the matrix is singular.
+     */
+    template <typename V> V
+    solve(const V& b) const {
+        if(singular) { throw std::runtime_error("Matrix is singular"); }
+        V x = b;
+        iterate<n>::apply([&](auto i) { x[i] = b[permutation[i]]; });
+        substitute([&](auto i) -> double& { return x[i]; });
+        return x;
+    }
+    
+    /*!
+     * @brief       Solves `A·X = B`, column by column.
+     * @throws      std::runtime_error if the matrix is singular.
+     */
+    template <int m> matrix<n, m>
+    solve(const matrix<n, m>& b) const {
+        if(singular) { throw std::runtime_error("Matrix is singular"); }
+        matrix<n, m> x;
+        iterate<m>::apply([&](auto j) {
+            iterate<n>::apply([&](auto i) { x[i][j] = b[permutation[i]][j]; });
+            substitute([&](auto i) -> double& { return x[i][j]; });
+        });
+        return x;
+    }
+    
+    /*!
+     * @brief       Returns the inverse of the decomposed matrix.
+     * @throws      std::runtime_error if the matrix is singular.
+     */
+    matrix<n, n>
+    inverse() const { return solve(matrix<n, n>::identity()); }
+    
+    /*!
+     * @brief       Returns the determinant of the decomposed matrix.
+     */
+    double
+    determinant() const {
+        if(singular) { return 0; }
+        double d = sign;
+        iterate<n>::apply([&](auto i) { d *= factors[i][i]; });
+        return d;
+    }
+    
+    /// Unit lower triangle below the diagonal (L), upper triangle on and above it (U).
+    matrix<n, n>    factors;
+    /// Row of `A` that ended up in each row of the factors.
+    int             permutation[n];
+    /// Sign of the permutation, `-1` for an odd number of row swaps.
+    int             sign;
+    bool            singular;
+    
+private:
+    
+    /// Forward then backward substitution, in place on an already permuted column.
+    template <typename Column> void
+    substitute(const Column& x) const {
+        iterate<n>::apply([&](auto i) {
+            iterate<n>::apply([&](auto j) { if(j < i) { x(i) -= factors[i][j] * x(j); } });
+        });
+        iterate<n>::reverse([&](auto i) {
+            iterate<n>::apply([&](auto j) { if(j > i) { x(i) -= factors[i][j] * x(j); } });
+            x(i) /= factors[i][i];
+        });
+    }
+};
+
+/*!
+ * @class       Cholesky
+ * @ingroup     Geometry
+ * @brief       Cholesky decomposition of a symmetric, positive definite matrix: `A = L·Lᵀ`.
+ * @details     About twice as cheap as `LU` and needs no pivoting, for covariances and
+ *              other normal matrices. Only the lower triangle of `A` is read.
+ * @tparam      n               The size of the matrix.
+ */
+template <int n>
+struct Cholesky {
+    
+    /*!
+     * @brief       Decomposes a matrix.
+     * @param       a           Matrix to decompose.
+     * @throws      std::runtime_error if the matrix is not positive definite.
+     */
+    explicit Cholesky(const matrix<n, n>& a) : lower(0.0) {
+        iterate<n>::apply([&](auto j) {
+            double diagonal = a[j][j];
+            iterate<n>::apply([&](auto k) { if(k < j) { diagonal -= lower[j][k] * lower[j][k]; } });
+            if(diagonal <= 0) { throw std::runtime_error("Matrix is not positive definite"); }
+            lower[j][j] = std::sqrt(diagonal);
+            iterate<n>::apply([&](auto i) {
+                if(i <= j) { return; }
+                double sum = a[i][j];
+                iterate<n>::apply([&](auto k) { if(k < j) { sum -= lower[i][k] * lower[j][k]; } });
+                lower[i][j] = sum / lower[j][j];
+            });
+        });
+    }
+    
+    /*!
+     * @brief       Solves `A·x = b` for a vector `b` (anything indexable with `[]`).
+     */
+    template <typename V> V
+    solve(const V& b) const {
+        V x = b;
+        substitute([&](auto i) -> double& { return x[i]; });
+        return x;
+    }
+    
+    /*!
+     * @brief       Solves `A·X = B`, column by column.
+     */
+    template <int m> matrix<n, m>
+    solve(const matrix<n, m>& b) const {
+        matrix<n, m> x(b);
+        iterate<m>::apply([&](auto j) { substitute([&](auto i) -> double& { return x[i][j]; }); });
+        return x;
+    }
+    
+    /*!
+     * @brief       Returns the inverse of the decomposed matrix.
+     */
+    matrix<n, n>
+    inverse() const { return solve(matrix<n, n>::identity()); }
+    
+    /*!
+     * @brief       Returns the determinant of the decomposed matrix.
+     */
+    double
+    determinant() const {
+        double d = 1;
+        iterate<n>::apply([&](auto i) { d *= lower[i][i]; });
+        return d * d;
+    }
+    
+    /// The lower triangular factor `L`; zero above the diagonal.
+    matrix<n, n>    lower;
+    
+private:
+    
+    /// Solves `L·y = b`, then `Lᵀ·x = y`, in place.
+    template <typename Column> void
+    substitute(const Column& x) const {
+        iterate<n>::apply([&](auto i) {
+            iterate<n>::apply([&](auto j) { if(j < i) { x(i) -= lower[i][j] * x(j); } });
+            x(i) /= lower[i][i];
+        });
+        iterate<n>::reverse([&](auto i) {
+            iterate<n>::apply([&](auto j) { if(j > i) { x(i) -= lower[j][i] * x(j); } });
+            x(i) /= lower[i][i];
+        });
+    }
+};
+
 /*!
  * @internal
  * @brief       3*3 square matrix.
@@ -301,4 +715,11 @@ typedef matrix<3,3> mat33;
  * @brief       4*4 square matrix.
  */
 typedef matrix<4,4> mat44;
+/*!
+ * @internal
+ * @brief       6*6 square matrix (state transition matrices, covariances).
+ */
+typedef matrix<6,6> mat66;
 
+static_assert(std::is_trivially_copyable<mat66>::value,
+              "matrices must stay trivially copyable");
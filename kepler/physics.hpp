@@ -9,21 +9,61 @@
 #pragma once
 #include "vec.hpp"
 
-struct State {
+/// Position and velocity, for any scalar type (dual numbers carry derivatives).
+template <typename T>
+struct BasicState {
     
-    State() : p(0, 0, 0), v(0, 0, 0) {}
-    State(const vec3& p, const vec3& v) : p(p), v(v) {}
+    BasicState() : p(0, 0, 0), v(0, 0, 0) {}
+    BasicState(const vec<T, 3>& p, const vec<T, 3>& v) : p(p), v(v) {}
     
-    vec3    p;
-    vec3    v;
+    vec<T, 3>   p;
+    vec<T, 3>   v;
 };
 
-struct Derivative {
+template <typename T>
+struct BasicDerivative {
     
-    Derivative() : dp(0, 0, 0), dv(0, 0, 0) {}
-    Derivative(const vec3& dp, const vec3& dv) : dp(dp), dv(dv) {}
+    BasicDerivative() : dp(0, 0, 0), dv(0, 0, 0) {}
+    BasicDerivative(const vec<T, 3>& dp, const vec<T, 3>& dv) : dp(dp), dv(dv) {}
     
-    vec3    dp;
-    vec3    dv;
+    vec<T, 3>   dp;
+    vec<T, 3>   dv;
 };
 
+using State = BasicState<double>;
+using Derivative = BasicDerivative<double>;
+
+
+/// Position and velocity augmented with `N` more variables integrated alongside
+/// them, to the same order. The first one is always the body's mass; the others
+/// are free for the caller (attitude, separate tanks...). Everything is sized at
+/// compile time, so integrating an augmented state never allocates.
+template <int N>
+struct AugmentedState {
+    static_assert(N >= 1, "An augmented state always carries the mass");
+    
+    AugmentedState() : p(0, 0, 0), v(0, 0, 0), q(0.0) {}
+    AugmentedState(const vec3& p, const vec3& v, const vec<double, N>& q) : p(p), v(v), q(q) {}
+    AugmentedState(const State& state, const vec<double, N>& q) : p(state.p), v(state.v), q(q) {}
+    
+    State motion() const { return State(p, v); }
+    double mass() const { return q.data[0]; }
+    
+    vec3            p;
+    vec3            v;
+    vec<double, N>  q;
+};
+
+template <int N>
+struct AugmentedDerivative {
+    
+    AugmentedDerivative() : dp(0, 0, 0), dv(0, 0, 0), dq(0.0) {}
+    AugmentedDerivative(const vec3& dp, const vec3& dv, const vec<double, N>& dq) : dp(dp), dv(dv), dq(dq) {}
+    
+    vec3            dp;
+    vec3            dv;
+    vec<double, N>  dq;
+};
+
+/// Position, velocity and mass.
+using MassState = AugmentedState<1>;
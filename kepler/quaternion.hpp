@@ -0,0 +1,235 @@
+//
+//  quaternion.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+
+#pragma once
+#include <cmath>
+#include <iostream>
+#include "vec.hpp"
+#include "matrix.hpp"
+
+/*!
+ * @class       quat
+ * @ingroup     Geometry
+ * @brief       A quaternion `w + xi + yj + zk`, used to represent rotations and attitudes.
+ * @details     Unit quaternions compose with a single product and rotate vectors with
+ *              two cross products, without the trigonometry and normalisation that
+ *              `vec3::rotate` redoes on every call. A rotation that is applied many times
+ *              (a frame change, a vehicle's attitude) should be built once as a `quat`,
+ *              then applied with `rotate()`, or turned into a `mat33` when it multiplies
+ *              many vectors in a row.
+ */
+struct quat {
+
+    /**
+     * @name        Creating Quaternions
+     * @{
+     */
+
+    /*!
+     * @brief       Creates a quaternion from its scalar and vector parts.
+     */
+    constexpr quat(double w, double x, double y, double z) : w(w), x(x), y(y), z(z) { }
+
+    /*!
+     * @brief       Creates the identity rotation.
+     */
+    constexpr quat() : quat(1, 0, 0, 0) { }
+
+    /*!
+     * @brief       Creates a rotation of `angle` radians around `axis`, right-handed.
+     * @param       axis        Axis of the rotation; it does not need to be normalised.
+     * @param       angle       Angle of the rotation, in radians.
+     */
+    static quat
+    axisAngle(const vec3& axis, double angle) {
+        const double s = std::sin(0.5 * angle) / axis.magnitude();
+        return quat(std::cos(0.5 * angle), axis.x * s, axis.y * s, axis.z * s);
+    }
+
+    /*!
+     * @brief       Creates the shortest rotation that turns the direction of `from` into
+     *              the direction of `to`.
+     * @note        Opposite directions have no single shortest rotation: a half turn
+     *              around an arbitrary perpendicular axis is returned.
+     */
+    static quat
+    between(const vec3& from, const vec3& to) {
+        const vec3 a = from.normalize();
+        const vec3 b = to.normalize();
+        const double d = dot(a, b);
+        if(d < -1 + 1e-12) {
+            const vec3 other = std::abs(a.x) < 0.9 ? vec3{1, 0, 0} : vec3{0, 1, 0};
+            return axisAngle(vec3::cross(a, other), M_PI);
+        }
+        // Half-way quaternion: (1 + a·b, a×b), normalised, is the rotation by the angle
+        // between a and b, without computing that angle.
+        const vec3 c = vec3::cross(a, b);
+        return quat(1 + d, c.x, c.y, c.z).normalize();
+    }
+
+    /*!
+     * @brief       Creates the rotation described by an orthonormal rotation matrix.
+     * @details     Uses Shepperd's method: the largest of the four components is
+     *              computed first, so no division by a small number ever happens.
+     */
+    static quat
+    fromMatrix(const mat33& m) {
+        const double trace = m[0][0] + m[1][1] + m[2][2];
+        if(trace > m[0][0] && trace > m[1][1] && trace > m[2][2]) {
+            const double s = 2 * std::sqrt(1 + trace);
+            return quat(0.25 * s, (m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s);
+        }
+        if(m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+            const double s = 2 * std::sqrt(1 + m[0][0] - m[1][1] - m[2][2]);
+            return quat((m[2][1] - m[1][2]) / s, 0.25 * s, (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s);
+        }
+        if(m[1][1] > m[2][2]) {
+            const double s = 2 * std::sqrt(1 + m[1][1] - m[0][0] - m[2][2]);
+            return quat((m[0][2] - m[2][0]) / s, (m[0][1] + m[1][0]) / s, 0.25 * s, (m[1][2] + m[2][1]) / s);
+        }
+        const double s = 2 * std::sqrt(1 + m[2][2] - m[0][0] - m[1][1]);
+        return quat((m[1][0] - m[0][1]) / s, (m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, 0.25 * s);
+    }
+
+    /**
+     * @}
+     */
+
+    /*!
+     * @brief       Returns the vector part `(x, y, z)`.
+     */
+    constexpr vec3
+    vector() const { return vec3{x, y, z}; }
+
+    /*!
+     * @brief       Returns the conjugate, which is the inverse rotation of a unit quaternion.
+     */
+    constexpr quat
+    conjugate() const { return quat(w, -x, -y, -z); }
+
+    /*!
+     * @brief       Get the quaternion's magnitude.
+     */
+    double
+    magnitude() const { return std::sqrt(w*w + x*x + y*y + z*z); }
+
+    /*!
+     * @brief       Returns the unit quaternion with the same direction. Products of unit
+     *              quaternions drift away from unit length slowly, so long chains of
+     *              compositions should be normalised from time to time.
+     */
+    quat
+    normalize() const {
+        const double length = magnitude();
+        if(length == 0 || length == 1) { return *this; }
+        const double inverse = 1 / length;
+        return quat(w * inverse, x * inverse, y * inverse, z * inverse);
+    }
+
+    /*!
+     * @brief       Rotates a vector by this unit quaternion, as `q·v·q*` would, in
+     *              two cross products: `v + w·t + u×t` with `t = 2·u×v`.
+     */
+    constexpr vec3
+    rotate(const vec3& v) const {
+        const vec3 u{x, y, z};
+        const vec3 t = vec3::cross(u, v) * 2.0;
+        return v + t * w + vec3::cross(u, t);
+    }
+
+    /*!
+     * @brief       Returns the rotation matrix of this unit quaternion, which is cheaper
+     *              to apply when the same rotation is used on many vectors.
+     */
+    constexpr mat33
+    rotationMatrix() const {
+        return mat33{
+            1 - 2*(y*y + z*z),  2*(x*y - w*z),      2*(x*z + w*y),
+            2*(x*y + w*z),      1 - 2*(x*x + z*z),  2*(y*z - w*x),
+            2*(x*z - w*y),      2*(y*z + w*x),      1 - 2*(x*x + y*y),
+        };
+    }
+
+    double  w, x, y, z;
+};
+
+static_assert(std::is_trivially_copyable<quat>::value, "quaternions must stay trivially copyable");
+
+// MARK: -
+// MARK: Operators
+
+/*!
+ * @brief       Hamilton product: the rotation `rhs`, followed by `lhs`.
+ */
+constexpr quat
+operator*(const quat& lhs, const quat& rhs) {
+    return quat(
+        lhs.w*rhs.w - lhs.x*rhs.x - lhs.y*rhs.y - lhs.z*rhs.z,
+        lhs.w*rhs.x + lhs.x*rhs.w + lhs.y*rhs.z - lhs.z*rhs.y,
+        lhs.w*rhs.y - lhs.x*rhs.z + lhs.y*rhs.w + lhs.z*rhs.x,
+        lhs.w*rhs.z + lhs.x*rhs.y - lhs.y*rhs.x + lhs.z*rhs.w
+    );
+}
+
+constexpr quat&
+operator*=(quat& lhs, const quat& rhs) { return lhs = lhs * rhs; }
+
+constexpr quat
+operator+(const quat& lhs, const quat& rhs) {
+    return quat(lhs.w + rhs.w, lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z);
+}
+
+constexpr quat
+operator*(const quat& lhs, double rhs) {
+    return quat(lhs.w * rhs, lhs.x * rhs, lhs.y * rhs, lhs.z * rhs);
+}
+
+constexpr quat
+operator*(double lhs, const quat& rhs) { return rhs * lhs; }
+
+constexpr quat
+operator/(const quat& lhs, double rhs) {
+    return quat(lhs.w / rhs, lhs.x / rhs, lhs.y / rhs, lhs.z / rhs);
+}
+
+constexpr quat
+operator-(const quat& rhs) { return quat(-rhs.w, -rhs.x, -rhs.y, -rhs.z); }
+
+constexpr double
+dot(const quat& a, const quat& b) { return a.w*b.w + a.x*b.x + a.y*b.y + a.z*b.z; }
+
+inline std::ostream&
+operator<<(std::ostream& s, const quat& q) {
+    return s << "(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+}
+
+// MARK: -
+// MARK: Interpolation
+
+/*!
+ * @brief       Spherical linear interpolation between two unit quaternions: rotates from
+ *              `from` to `to` at a constant angular rate, along the shorter way.
+ * @param       from        Rotation at `t = 0`.
+ * @param       to          Rotation at `t = 1`.
+ * @param       t           Interpolation parameter.
+ */
+inline quat
+slerp(const quat& from, const quat& to, double t) {
+    // q and -q are the same rotation: pick the sign that takes the short way.
+    double d = dot(from, to);
+    const quat end = d < 0 ? -to : to;
+    d = std::abs(d);
+
+    // Nearly identical rotations: sin(θ) vanishes, and a normalised lerp is as accurate.
+    if(d > 0.9995) {
+        return (from * (1 - t) + end * t).normalize();
+    }
+    const double theta = std::acos(d);
+    const double inverse = 1 / std::sin(theta);
+    return from * (std::sin((1 - t) * theta) * inverse) + end * (std::sin(t * theta) * inverse);
+}
@@ -0,0 +1,189 @@
+//
+//  simd.hpp
+//  kepler
+//
+//  Created by Amy Parent on 19/10/2026.
+//  Copyright © 2026 Amy Parent. All rights reserved.
+//
+//  Vector-unit implementations of the common vec3/vec4 operations, included by
+//  vec.hpp when building with `KEPLER_SIMD=1`. Both types then hold four lanes (the
+//  fourth one of a vec3 is a zero pad), so they load whole into one AVX register or
+//  two SSE2 ones. Every operation computes the same IEEE operations in the same order
+//  as the scalar templates, so results are identical bit for bit; in constant
+//  expressions the scalar path is taken instead.
+//
+//  Vectors are 16-byte aligned, which plain `new` guarantees; with AVX, a vector
+//  may straddle two 32-byte lines, so every load and store is an unaligned one.
+//
+
+#pragma once
+#if !defined(__SSE2__)
+#error "KEPLER_SIMD needs a target with SSE2"
+#endif
+#include <cmath>
+#include <immintrin.h>
+#include <type_traits>
+
+/*!
+ * @internal
+ * @brief       Four doubles in vector registers: one AVX register, or a pair of SSE2 ones.
+ */
+struct simd4 {
+#if defined(__AVX__)
+    static simd4 load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    static simd4 splat(double s) { return {_mm256_set1_pd(s)}; }
+    static simd4 join(__m128d lo, __m128d hi) { return {_mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+    __m128d low() const { return _mm256_castpd256_pd128(v); }
+    __m128d high() const { return _mm256_extractf128_pd(v, 1); }
+
+    __m256d v;
+#else
+    static simd4 load(const double* p) { return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)}; }
+    static simd4 splat(double s) { return {_mm_set1_pd(s), _mm_set1_pd(s)}; }
+    static simd4 join(__m128d lo, __m128d hi) { return {lo, hi}; }
+    void store(double* p) const { _mm_storeu_pd(p, lo); _mm_storeu_pd(p + 2, hi); }
+    __m128d low() const { return lo; }
+    __m128d high() const { return hi; }
+
+    __m128d lo, hi;
+#endif
+};
+
+#if defined(__AVX__)
+inline simd4 operator+(simd4 a, simd4 b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline simd4 operator-(simd4 a, simd4 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline simd4 operator*(simd4 a, simd4 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline simd4 operator/(simd4 a, simd4 b) { return {_mm256_div_pd(a.v, b.v)}; }
+#else
+inline simd4 operator+(simd4 a, simd4 b) { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+inline simd4 operator-(simd4 a, simd4 b) { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+inline simd4 operator*(simd4 a, simd4 b) { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+inline simd4 operator/(simd4 a, simd4 b) { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+#endif
+
+/// @internal The vector types that are backed by `simd4`.
+template <int S>
+using packed = typename std::enable_if<storage<double, S>::lanes == 4, vec<double, S>>::type;
+
+// MARK: -
+// MARK: Compound Operators
+
+// Only the operations that keep the zero pad of a vec3 at zero go through the vector
+// units: component-wise products and quotients of two vectors stay scalar.
+
+template <int S> constexpr packed<S>&
+operator+=(vec<double, S>& lhs, const vec<double, S>& rhs) {
+    if(constantEvaluated()) {
+        for(int i = 0; i < S; ++i) { lhs.data[i] += rhs.data[i]; }
+        return lhs;
+    }
+    (simd4::load(lhs.data) + simd4::load(rhs.data)).store(lhs.data);
+    return lhs;
+}
+
+template <int S> constexpr packed<S>&
+operator-=(vec<double, S>& lhs, const vec<double, S>& rhs) {
+    if(constantEvaluated()) {
+        for(int i = 0; i < S; ++i) { lhs.data[i] -= rhs.data[i]; }
+        return lhs;
+    }
+    (simd4::load(lhs.data) - simd4::load(rhs.data)).store(lhs.data);
+    return lhs;
+}
+
+template <int S> constexpr packed<S>&
+operator*=(vec<double, S>& lhs, double rhs) {
+    if(constantEvaluated()) {
+        for(int i = 0; i < S; ++i) { lhs.data[i] *= rhs; }
+        return lhs;
+    }
+    (simd4::load(lhs.data) * simd4::splat(rhs)).store(lhs.data);
+    return lhs;
+}
+
+template <int S> constexpr packed<S>&
+operator/=(vec<double, S>& lhs, double rhs) {
+    if(constantEvaluated()) {
+        for(int i = 0; i < S; ++i) { lhs.data[i] /= rhs; }
+        return lhs;
+    }
+    (simd4::load(lhs.data) / simd4::splat(rhs)).store(lhs.data);
+    return lhs;
+}
+
+// MARK: -
+// MARK: Products
+
+/*!
+ * @brief       Returns the dot product of two vec3 or vec4, in vector registers. The
+ *              lanes are summed in order, as the scalar version does.
+ */
+template <int S> constexpr typename std::enable_if<storage<double, S>::lanes == 4, double>::type
+dot(const vec<double, S>& a, const vec<double, S>& b) {
+    if(constantEvaluated()) {
+        double prod = 0;
+        for(int i = 0; i < S; ++i) { prod += a.data[i] * b.data[i]; }
+        return prod;
+    }
+    simd4 p = simd4::load(a.data) * simd4::load(b.data);
+    __m128d xy = p.low(), zw = p.high();
+    __m128d sum = _mm_add_sd(xy, _mm_unpackhi_pd(xy, xy));
+    sum = _mm_add_sd(sum, zw);
+    if(S == 4) { sum = _mm_add_sd(sum, _mm_unpackhi_pd(zw, zw)); }
+    return _mm_cvtsd_f64(sum);
+}
+
+template <> constexpr vec<double, 3>
+vec<double, 3>::cross(const vec& a, const vec& b) {
+    if(constantEvaluated()) {
+        return vec {
+             (a.data[1]*b.data[2] - a.data[2]*b.data[1]),
+            -(a.data[0]*b.data[2] - a.data[2]*b.data[0]),
+             (a.data[0]*b.data[1] - a.data[1]*b.data[0])
+        };
+    }
+    const __m128d axy = _mm_loadu_pd(a.data), azw = _mm_loadu_pd(a.data + 2);
+    const __m128d bxy = _mm_loadu_pd(b.data), bzw = _mm_loadu_pd(b.data + 2);
+
+    // (ay*bz - az*by, ax*bz - az*bx), then the sign of the second lane is flipped.
+    __m128d xy = _mm_sub_pd(_mm_mul_pd(_mm_shuffle_pd(axy, axy, 1), _mm_unpacklo_pd(bzw, bzw)),
+                            _mm_mul_pd(_mm_unpacklo_pd(azw, azw), _mm_shuffle_pd(bxy, bxy, 1)));
+    xy = _mm_xor_pd(xy, _mm_set_pd(-0.0, 0.0));
+
+    // ax*by - ay*bx, with a zero pad.
+    __m128d t = _mm_mul_pd(axy, _mm_shuffle_pd(bxy, bxy, 1));
+    __m128d z = _mm_move_sd(_mm_setzero_pd(), _mm_sub_sd(t, _mm_unpackhi_pd(t, t)));
+
+    // A single store: reading back two half-width stores with one AVX load would
+    // stall store forwarding.
+    vec r;
+    simd4::join(xy, z).store(r.data);
+    return r;
+}
+
+// MARK: -
+// MARK: Magnitude and normalisation
+
+template <> inline double
+vec<double, 3>::magnitude() const {
+    return std::sqrt(dot(*this, *this));
+}
+
+template <> inline vec<double, 3>
+vec<double, 3>::normalize(double len) const {
+    double length = magnitude();
+    if(length == 0 || length == 1) { return *this; }
+    vec r;
+    (simd4::load(data) * simd4::splat(len / length)).store(r.data);
+    return r;
+}
+
+template <> inline vec<double, 4>
+vec<double, 4>::normalize(float length) const {
+    float _length = magnitude();
+    if(_length == 0) { return vec{0.0}; }
+    vec r;
+    (simd4::load(data) * simd4::splat(length / _length)).store(r.data);
+    return r;
+}
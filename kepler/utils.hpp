@@ -10,6 +10,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <type_traits>
 
 /*!
  * @brief       Converts an angle in degrees to radians.
@@ -104,3 +105,72 @@ lerp(T from, T to, float t) {
     return (1-t)*from + t*to;
 }
 
+/*!
+ * @internal
+ * @brief       Whether the caller is being evaluated as a constant expression, where
+ *              intrinsics and other run-time-only code cannot be used.
+ */
+constexpr bool
+constantEvaluated() { return __builtin_is_constant_evaluated(); }
+
+/*!
+ * @internal
+ * @brief       Calls `f(I)`, `f(I+1)`... `f(N-1)`, unrolled at compile time. Used for
+ *              the short fixed-length loops of dual numbers, vector expressions and
+ *              matrix decompositions, where it makes a large difference at optimisation
+ *              levels that do not unroll loops themselves. Indices are passed as
+ *              `std::integral_constant`s, which convert to `int`; generic lambdas can
+ *              keep them as constants, and branches on them then fold away.
+ */
+template <int I, int N>
+struct unrolled {
+    template <typename F>
+    static void apply(const F& f) {
+        f(std::integral_constant<int, I>());
+        unrolled<I + 1, N>::apply(f);
+    }
+    
+    /// Same, from `N-1` down to `I`.
+    template <typename F>
+    static void reverse(const F& f) {
+        unrolled<I + 1, N>::reverse(f);
+        f(std::integral_constant<int, I>());
+    }
+};
+
+template <int N>
+struct unrolled<N, N> {
+    template <typename F>
+    static void apply(const F&) {}
+    
+    template <typename F>
+    static void reverse(const F&) {}
+};
+
+/*!
+ * @internal
+ * @brief       Calls `f(0)`... `f(N-1)`: unrolled for small `N`, where every index then
+ *              becomes a constant, and as a plain loop past that.
+ */
+template <int N, bool unroll = (N <= 8)>
+struct iterate {
+    template <typename F>
+    static void apply(const F& f) { unrolled<0, N>::apply(f); }
+    
+    /// Same, from `N-1` down to `0`.
+    template <typename F>
+    static void reverse(const F& f) { unrolled<0, N>::reverse(f); }
+};
+
+template <int N>
+struct iterate<N, false> {
+    template <typename F>
+    static void apply(const F& f) {
+        for(int i = 0; i < N; ++i) { f(i); }
+    }
+    
+    template <typename F>
+    static void reverse(const F& f) {
+        for(int i = N - 1; i >= 0; --i) { f(i); }
+    }
+};
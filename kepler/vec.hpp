@@ -10,7 +10,37 @@
 #include "matrix.hpp"
 #include <cmath>
 #include <iostream>
+#include <type_traits>
 
+/*!
+ * @internal
+ * @brief       How many components a vector stores, and how they are aligned. Built with
+ *              `KEPLER_SIMD`, `vec<double, 3>` is padded with a fourth, zero component, and
+ *              both it and `vec<double, 4>` are 16-byte aligned (see simd.hpp).
+ */
+template <typename T, int size>
+struct storage {
+    static const int lanes = size;
+    static const int alignment = alignof(T);
+};
+
+#if KEPLER_SIMD
+// Capped at 16 bytes, even with AVX: gnu++14 `new` only guarantees that much, and
+// over-aligned vectors in containers would be misaligned. Loads never rely on it.
+static const int simdAlignment = 16;
+
+template <>
+struct storage<double, 3> {
+    static const int lanes = 4;
+    static const int alignment = simdAlignment;
+};
+
+template <>
+struct storage<double, 4> {
+    static const int lanes = 4;
+    static const int alignment = simdAlignment;
+};
+#endif
 
 /*!
  * @class       vec
@@ -35,7 +65,7 @@ struct vec {
      * @brief       Creates a vector from a list of values.
      * @param       values      List ofVector's components.
      */
-    vec(T values[size]) {
+    constexpr vec(const T values[size]) : data{} {
         for(int i = 0; i < size; ++i) {
             data[i] = values[i];
         }
@@ -45,7 +75,7 @@ struct vec {
      * @brief       Creates a vector with a single value for each of its components
      * @param       value       Value of every component of the vector.
      */
-    vec(T value = 0) {
+    constexpr vec(T value = 0) : data{} {
         for(int i = 0; i < size; ++i) {
             data[i] = value;
         }
@@ -58,7 +88,7 @@ struct vec {
      * @param       vec         Vector to create the new vector with.
      * @param       rem         Value to fill the remaining member with. Defaults to `0`
      */
-    vec(const vec<T, size-1>& vec, T rem = 0) {
+    constexpr vec(const vec<T, size-1>& vec, T rem = 0) : data{} {
         for(int i = 0; i < size-1; ++i) {
             data[i] = vec.data[i];
         }
@@ -69,39 +99,13 @@ struct vec {
      * @}
      */
     
-    /*!
-     * @internal
-     * @brief       Copies a vector into another.
-     * @param       rhs         Copied vector
-     */
-    vec(const vec<T, size>& rhs) {
-        for(int i = 0; i < size; ++i) {
-            data[i] = rhs.data[i];
-        }
-    }
-    
-    /*!
-     * @internal
-     * @brief       Assigment operator (Copy semantics).
-     * @param       rhs         Copied vector.
-     */
-    vec&
-    operator=(const vec<T, size>& rhs) {
-        if(this != &rhs) {
-            for(int i = 0; i < size; ++i) {
-                data[i] = rhs.data[i];
-            }
-        }
-        return *this;
-    }
-    
     /*!
      * @internal
      * @brief       Conversion operations between vectors of different types.
      *              The origin type T must be cast-able to the destination type P.
      */
     template<typename P>
-    operator vec<P, size>() const {
+    constexpr operator vec<P, size>() const {
         vec<P, size> v;
         for(int i = 0; i < size; ++i) {
             v.data[i] = (P)data[i];
@@ -150,13 +154,20 @@ struct vec {
      * @internal
      * @brief       Vector members accessor.
      */
-    T&
+    constexpr T&
     operator[](int i) { return data[i]; }
     
+    /*!
+     * @internal
+     * @brief       Vector members accessor.
+     */
+    constexpr const T&
+    operator[](int i) const { return data[i]; }
+    
     /*!
      * @brief       Array storing the vector's components
      */
-    T       data[size];
+    alignas(storage<T, size>::alignment) T data[storage<T, size>::lanes];
     
 };
 
@@ -165,7 +176,7 @@ struct vec {
 // MARK: Compound Operators
 
 // vec += vec
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator+=(vec<T, S>& lhs, const vec<T, S>& rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] += (T)rhs.data[i];
@@ -174,7 +185,7 @@ operator+=(vec<T, S>& lhs, const vec<T, S>& rhs) {
 }
 
 // vec -= vec
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator-=(vec<T, S>& lhs, const vec<T, S>& rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] -= (T)rhs.data[i];
@@ -183,7 +194,7 @@ operator-=(vec<T, S>& lhs, const vec<T, S>& rhs) {
 }
 
 // vec *= vec
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator*=(vec<T, S>& lhs, const vec<T, S>& rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] *= (T)rhs.data[i];
@@ -192,7 +203,7 @@ operator*=(vec<T, S>& lhs, const vec<T, S>& rhs) {
 }
 
 // vec *= scalar
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator*=(vec<T, S>& lhs, double rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] *= rhs;
@@ -201,7 +212,7 @@ operator*=(vec<T, S>& lhs, double rhs) {
 }
 
 // vec /= vec
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator/=(vec<T, S>& lhs, const vec<T, S>& rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] /= (T)rhs.data[i];
@@ -210,7 +221,7 @@ operator/=(vec<T, S>& lhs, const vec<T, S>& rhs) {
 }
 
 // vec /= scalar
-template<typename T, int S> vec<T, S>&
+template<typename T, int S> constexpr vec<T, S>&
 operator/=(vec<T, S>& lhs, double rhs) {
     for(int i = 0; i < S; ++i) {
         lhs.data[i] /= rhs;
@@ -222,55 +233,55 @@ operator/=(vec<T, S>& lhs, double rhs) {
 // MARK: binary operators
 
 // vec + vec
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator+(const vec<T, S>& lhs, const vec<T, S>& rhs) {
     vec<T, S> v(lhs);
     return v += rhs;
 }
 
 // vec - vec
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator-(const vec<T, S>& lhs, const vec<T, S>& rhs) {
     vec<T, S> v(lhs);
     return v -= rhs;
 }
 
 // vec * vec
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator*(const vec<T, S>& lhs, const vec<T, S>& rhs) {
     vec<T, S> v(lhs);
     return v *= rhs;
 }
 
 // vec * scalar
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator*(const vec<T, S>& lhs, double rhs) {
     vec<T, S> v(lhs);
     return v *= rhs;
 }
 
 // scalar * vec
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator*(double lhs, const vec<T, S>& rhs) {
     vec<T, S> v(rhs);
     return v *= lhs;
 }
 
 // vec / vec
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator/(const vec<T, S>& lhs, const vec<T, S>& rhs) {
     vec<T, S> v(lhs);
     return v /= rhs;
 }
 
 // vec / scalar
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator/(const vec<T, S>& lhs, double rhs) {
     vec<T, S> v(lhs);
     return v /= rhs;
 }
 
-template<typename T, int S> const vec<T, S>
+template<typename T, int S> constexpr const vec<T, S>
 operator/(double lhs, const vec<T, S>& rhs) {
     vec<T, S> v{0};
     for(int i = 0; i < S; ++i) {
@@ -283,12 +294,11 @@ operator/(double lhs, const vec<T, S>& rhs) {
  * @internal
  * @brief       Multiply a vector by a matrix.
  */
-template<typename T, int r, int c> const vec<T, c>
+template<typename T, int r, int c> constexpr const vec<T, c>
 operator*(const matrix<r,c>& lhs, const vec<T,c>& rhs) {
-    vec<T,c> v = 0;
-    T temp;
+    vec<T,c> v = T(0);
     for(int i = 0; i < c; ++i) {
-        temp = 0;
+        T temp = 0;
         for(int k = 0; k < c; ++k) {
             temp += (T)lhs[i][k] * rhs.data[k];
         }
@@ -316,7 +326,7 @@ operator<<(std::ostream& s, const vec<T, S>& v) {
 // MARK: -
 // MARK: Unary minus operator
 
-template<typename T, int S> vec<T, S>
+template<typename T, int S> constexpr vec<T, S>
 operator-(const vec<T, S>& rhs) {
     return -1*vec<T, S>(rhs);
 }
@@ -330,7 +340,7 @@ operator-(const vec<T, S>& rhs) {
  * @param       b       Second vector.
  * @return      Result of the dot product of a and b.
  */
-template<typename T, int S> T
+template<typename T, int S> constexpr T
 dot(const vec<T, S>& a, const vec<T, S>& b) {
     T prod{};
     for(int i = 0; i < S; ++i) {
@@ -353,30 +363,19 @@ struct vec<T, 2> {
     /*!
      * @brief       Create a vector from its x and y components.
      */
-    vec(T x, T y) : x(x), y(y) { }
-    
-    /*!
-     * @brief       Create a vector from another vector.
-     */
-    vec(const vec<T, 2>& rhs) {
-        x = rhs.x;
-        y = rhs.y;
-    }
+    constexpr vec(T x, T y) : data{x, y} { }
     
     /*!
      * @brief       Create a vector with a fied value for its components
      */
-    vec(T value = 0) {
-        x = value;
-        y = value;
-    }
+    constexpr vec(T value = 0) : data{value, value} { }
     
     /*!
      * @brief       Vector cast operator
      */
     template<typename P>
-    operator vec<P, 2>() const {
-        return vec<P, 2>(P(x), P(y));
+    constexpr operator vec<P, 2>() const {
+        return vec<P, 2>(P(data[0]), P(data[1]));
     }
     
     /*!
@@ -384,7 +383,8 @@ struct vec<T, 2> {
      */
     T
     magnitude() const {
-        return std::sqrt(x*x + y*y);
+        using std::sqrt;
+        return sqrt(x*x + y*y);
     }
     
     /*!
@@ -397,6 +397,20 @@ struct vec<T, 2> {
         return vec<T, 2>(*this) * (len / _length);
     }
     
+    /*!
+     * @internal
+     * @brief       Vector members accessor.
+     */
+    constexpr T&
+    operator[](int i) { return data[i]; }
+    
+    /*!
+     * @internal
+     * @brief       Vector members accessor.
+     */
+    constexpr const T&
+    operator[](int i) const { return data[i]; }
+    
     union {
         T data[2];
         struct { T x,y; };
@@ -415,41 +429,24 @@ struct vec<T, 3> {
     /*!
      * @brief       Create a vector from its x, y and z components.
      */
-    vec(T x, T y, T z) : x(x), y(y), z(z) { }
-    
-    /*!
-     * @brief       Create a vector from another vector.
-     */
-    vec(const vec<T, 3>& rhs) {
-        x = rhs.x;
-        y = rhs.y;
-        z = rhs.z;
-    }
+    constexpr vec(T x, T y, T z) : data{x, y, z} { }
     
     /*!
      * @bief        Create a 3D vector from a 2D vector, filling Z with rem.
      */
-    vec(const vec<T, 2>& rhs, float rem = 0) {
-        x = rhs.x;
-        y = rhs.y;
-        z = rem;
-    }
+    constexpr vec(const vec<T, 2>& rhs, float rem = 0) : data{rhs.data[0], rhs.data[1], T(rem)} { }
     
     /*!
      * @brief       Create a vector with a fied value for its components
      */
-    vec(T value = 0) {
-        x = value;
-        y = value;
-        z = value;
-    }
+    constexpr vec(T value = 0) : data{value, value, value} { }
     
     /*!
      * @brief       Vector cast operator
      */
     template<typename P>
-    operator vec<P, 3>() const {
-        return vec<P, 3>((P)x, (P)y, (P)z);
+    constexpr operator vec<P, 3>() const {
+        return vec<P, 3>((P)data[0], (P)data[1], (P)data[2]);
     }
     
     /*!
@@ -457,20 +454,25 @@ struct vec<T, 3> {
      */
     T
     magnitude() const {
-        return std::sqrt(x*x + y*y + z*z);
+        using std::sqrt;
+        return sqrt(x*x + y*y + z*z);
     }
     
-    static vec
+    static constexpr vec
     cross(const vec& a, const vec& b) {
+        // Constant expressions may only read the union member that was initialised,
+        // so this goes through `data` rather than x/y/z.
         return vec {
-             (a.y*b.z - a.z*b.y),
-            -(a.x*b.z - a.z*b.x),
-             (a.x*b.y - a.y*b.x)
+             (a.data[1]*b.data[2] - a.data[2]*b.data[1]),
+            -(a.data[0]*b.data[2] - a.data[2]*b.data[0]),
+             (a.data[0]*b.data[1] - a.data[1]*b.data[0])
         };
     }
     
     /*!
      * Rodriges rotation formula
+     * @note        Builds the rotation from scratch on every call: rotations that are
+     *              composed or reused should be built once as a `quat` (quaternion.hpp).
      */
     vec
     rotate(const vec& axis, double angle) const {
@@ -499,8 +501,22 @@ struct vec<T, 3> {
         return vec<T, 3>(*this) * (len / _length);
     }
     
+    /*!
+     * @internal
+     * @brief       Vector members accessor.
+     */
+    constexpr T&
+    operator[](int i) { return data[i]; }
+    
+    /*!
+     * @internal
+     * @brief       Vector members accessor.
+     */
+    constexpr const T&
+    operator[](int i) const { return data[i]; }
+    
     union {
-        T data[3];
+        alignas(storage<T, 3>::alignment) T data[storage<T, 3>::lanes];
         struct { T x,y,z; };
         vec<T, 2> xy;
     };
@@ -512,3 +528,9 @@ typedef vec<double, 2> vec2;
 /// @brief      3D float-precision vector
 typedef vec<double, 3> vec3;
 
+static_assert(std::is_trivially_copyable<vec2>::value && std::is_trivially_copyable<vec3>::value,
+              "vectors must stay trivially copyable");
+
+#if KEPLER_SIMD
+#include "simd.hpp"
+#endif